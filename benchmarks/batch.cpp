@@ -0,0 +1,138 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <random>
+#include <vector>
+
+#include "skip_list.hpp"
+
+namespace {
+
+using list = sl::skip_list<int, std::less<int>, sl::DEFAULT_PROBABILITY, 16>;
+
+constexpr int LIST_SIZE = 1 << 16;
+
+// A list of the even numbers below 2 * LIST_SIZE.
+list even_list() {
+  list sl;
+  std::seed_seq seed{7};
+  sl.set_seed(seed);
+  for (int key = 0; key < 2 * LIST_SIZE; key += 2) {
+    sl.insert(sl.end(), key);
+  }
+  return sl;
+}
+
+// At most `count` distinct odd keys spread over the whole list, a batch
+// about as dense as the list when `count` is LIST_SIZE.
+std::vector<int> sorted_batch(std::size_t count) {
+  std::vector<int> keys(count);
+  std::mt19937 gen(42);
+  std::uniform_int_distribution<int> key(0, LIST_SIZE - 1);
+  std::generate(keys.begin(), keys.end(), [&] { return 2 * key(gen) + 1; });
+  std::sort(keys.begin(), keys.end());
+  keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+  return keys;
+}
+
+template <bool Batched> void BM_FindSorted(benchmark::State &state) {
+  const auto sl = even_list();
+  const auto keys = sorted_batch(static_cast<std::size_t>(state.range(0)));
+  std::vector<list::const_iterator> found(keys.size());
+  for (auto _ : state) {
+    if constexpr (Batched) {
+      sl.find_many(keys.begin(), keys.end(), found.begin());
+    } else {
+      std::transform(keys.begin(), keys.end(), found.begin(),
+                     [&](int key) { return sl.find(key); });
+    }
+    benchmark::DoNotOptimize(found.data());
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<std::int64_t>(keys.size()));
+}
+
+// Inserts the batch then erases it again, the list keeps its size.
+template <bool Batched> void BM_InsertEraseSorted(benchmark::State &state) {
+  auto sl = even_list();
+  const auto keys = sorted_batch(static_cast<std::size_t>(state.range(0)));
+  for (auto _ : state) {
+    if constexpr (Batched) {
+      sl.insert_sorted(keys.begin(), keys.end());
+      sl.erase_many(keys.begin(), keys.end());
+    } else {
+      for (auto key : keys) {
+        sl.insert(key);
+      }
+      for (auto key : keys) {
+        sl.erase(key);
+      }
+    }
+    benchmark::DoNotOptimize(sl.size());
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<std::int64_t>(keys.size()));
+}
+
+// Looks up shuffled keys, half of them missing, in a list of `range(0)`
+// elements large enough to miss the caches.
+template <bool Batched> void BM_FindRandom(benchmark::State &state) {
+  const auto count{static_cast<int>(state.range(0))};
+  list sl;
+  std::seed_seq seed{7};
+  sl.set_seed(seed);
+  for (int key = 0; key < 2 * count; key += 2) {
+    sl.insert(sl.end(), key);
+  }
+  std::vector<int> keys(4096u);
+  std::mt19937 gen(42);
+  std::uniform_int_distribution<int> random_key(0, 2 * count - 1);
+  std::generate(keys.begin(), keys.end(), [&] { return random_key(gen); });
+  std::vector<list::const_iterator> found(keys.size());
+  for (auto _ : state) {
+    if constexpr (Batched) {
+      sl.find_batch(keys, found);
+    } else {
+      std::transform(keys.begin(), keys.end(), found.begin(),
+                     [&](int key) { return sl.find(key); });
+    }
+    benchmark::DoNotOptimize(found.data());
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<std::int64_t>(keys.size()));
+}
+
+// Intersects `range(0)` keys with the whole list, the posting list query.
+template <bool Galloping> void BM_Intersect(benchmark::State &state) {
+  const auto sl = even_list();
+  const auto keys = sorted_batch(static_cast<std::size_t>(state.range(0)));
+  list small(keys.begin(), keys.end());
+  for (auto &key : keys) {
+    small.insert(key - 1);
+  }
+  for (auto _ : state) {
+    if constexpr (Galloping) {
+      benchmark::DoNotOptimize(set_intersection(small, sl).size());
+    } else {
+      list both;
+      std::set_intersection(small.begin(), small.end(), sl.begin(), sl.end(),
+                            std::inserter(both, both.end()));
+      benchmark::DoNotOptimize(both.size());
+    }
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<std::int64_t>(small.size()));
+}
+
+} // namespace
+
+BENCHMARK(BM_FindSorted<false>)->Range(1 << 6, LIST_SIZE);
+BENCHMARK(BM_FindSorted<true>)->Range(1 << 6, LIST_SIZE);
+BENCHMARK(BM_InsertEraseSorted<false>)->Range(1 << 6, LIST_SIZE);
+BENCHMARK(BM_InsertEraseSorted<true>)->Range(1 << 6, LIST_SIZE);
+BENCHMARK(BM_FindRandom<false>)->Range(1 << 10, 1 << 20);
+BENCHMARK(BM_FindRandom<true>)->Range(1 << 10, 1 << 20);
+BENCHMARK(BM_Intersect<false>)->Range(1 << 6, LIST_SIZE);
+BENCHMARK(BM_Intersect<true>)->Range(1 << 6, LIST_SIZE);
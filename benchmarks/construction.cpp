@@ -0,0 +1,74 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+#include "skip_list.hpp"
+
+namespace {
+
+using list = sl::skip_list<int, std::less<int>, sl::DEFAULT_PROBABILITY, 16>;
+using indexed_list =
+    sl::indexed_skip_list<int, std::less<int>, sl::DEFAULT_PROBABILITY, 16>;
+
+std::vector<int> sorted_keys(std::size_t count) {
+  std::vector<int> keys(count);
+  std::iota(keys.begin(), keys.end(), 0);
+  return keys;
+}
+
+void BM_BuildSortedRange(benchmark::State &state) {
+  const auto keys = sorted_keys(static_cast<std::size_t>(state.range(0)));
+  for (auto _ : state) {
+    list sl(keys.begin(), keys.end());
+    benchmark::DoNotOptimize(sl.size());
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<std::int64_t>(keys.size()));
+}
+
+void BM_BuildSortedEmplace(benchmark::State &state) {
+  const auto keys = sorted_keys(static_cast<std::size_t>(state.range(0)));
+  for (auto _ : state) {
+    list sl;
+    for (auto key : keys) {
+      sl.emplace(key);
+    }
+    benchmark::DoNotOptimize(sl.size());
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<std::int64_t>(keys.size()));
+}
+
+void BM_Copy(benchmark::State &state) {
+  const auto keys = sorted_keys(static_cast<std::size_t>(state.range(0)));
+  const list source(keys.begin(), keys.end());
+  for (auto _ : state) {
+    list copy(source);
+    benchmark::DoNotOptimize(copy.size());
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<std::int64_t>(keys.size()));
+}
+
+// Moves the upper three quarters of the list out and back. Indexed lists
+// know the size of the cut, plain ones count the shorter side.
+template <typename SkipList> void BM_SplitJoin(benchmark::State &state) {
+  const auto keys = sorted_keys(static_cast<std::size_t>(state.range(0)));
+  SkipList sl(keys.begin(), keys.end());
+  const auto cut{static_cast<int>(keys.size() / 4u)};
+  for (auto _ : state) {
+    auto suffix = sl.split(cut);
+    sl.join(suffix);
+    benchmark::DoNotOptimize(sl.size());
+  }
+}
+
+} // namespace
+
+BENCHMARK(BM_BuildSortedRange)->Range(1 << 8, 1 << 18);
+BENCHMARK(BM_BuildSortedEmplace)->Range(1 << 8, 1 << 16);
+BENCHMARK(BM_Copy)->Range(1 << 8, 1 << 18);
+BENCHMARK(BM_SplitJoin<list>)->Range(1 << 8, 1 << 18);
+BENCHMARK(BM_SplitJoin<indexed_list>)->Range(1 << 8, 1 << 18);
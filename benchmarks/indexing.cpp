@@ -0,0 +1,82 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <iterator>
+#include <random>
+#include <type_traits>
+#include <vector>
+
+#include "skip_list.hpp"
+
+namespace {
+
+template <typename SkipList> SkipList sequence_list(int size) {
+  SkipList sl;
+  std::seed_seq seed{7};
+  sl.set_seed(seed);
+  for (int key = 0; key < size; ++key) {
+    sl.insert(sl.end(), key);
+  }
+  return sl;
+}
+
+std::vector<std::ptrdiff_t> random_positions(int size) {
+  std::vector<std::ptrdiff_t> positions(1024u);
+  std::mt19937 gen(42);
+  std::uniform_int_distribution<std::ptrdiff_t> position(0, size - 1);
+  for (auto &it : positions) {
+    it = position(gen);
+  }
+  return positions;
+}
+
+// Reaches random positions walking level 0 of a plain list, or skipping
+// along the link widths of an indexed one.
+template <bool Indexed> void BM_Advance(benchmark::State &state) {
+  using list = std::conditional_t<
+      Indexed, sl::indexed_skip_list<int, std::less<int>,
+                                     sl::DEFAULT_PROBABILITY, 16>,
+      sl::skip_list<int, std::less<int>, sl::DEFAULT_PROBABILITY, 16>>;
+  const auto size{static_cast<int>(state.range(0))};
+  const auto sl = sequence_list<list>(size);
+  const auto positions = random_positions(size);
+  for (auto _ : state) {
+    for (auto position : positions) {
+      if constexpr (Indexed) {
+        benchmark::DoNotOptimize(*(sl.begin() + position));
+      } else {
+        benchmark::DoNotOptimize(*std::next(sl.begin(), position));
+      }
+    }
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<std::int64_t>(positions.size()));
+}
+
+// Keeping the widths up to date costs insertions and erasures a little.
+template <bool Indexed> void BM_InsertErase(benchmark::State &state) {
+  using list = std::conditional_t<
+      Indexed, sl::indexed_skip_list<int, std::less<int>,
+                                     sl::DEFAULT_PROBABILITY, 16>,
+      sl::skip_list<int, std::less<int>, sl::DEFAULT_PROBABILITY, 16>>;
+  const auto size{static_cast<int>(state.range(0))};
+  auto sl = sequence_list<list>(size);
+  const auto positions = random_positions(size);
+  for (auto _ : state) {
+    for (auto position : positions) {
+      sl.insert(static_cast<int>(position));
+    }
+    for (auto position : positions) {
+      sl.erase(static_cast<int>(position));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<std::int64_t>(positions.size()));
+}
+
+} // namespace
+
+BENCHMARK(BM_Advance<false>)->Range(1 << 8, 1 << 16);
+BENCHMARK(BM_Advance<true>)->Range(1 << 8, 1 << 16);
+BENCHMARK(BM_InsertErase<false>)->Range(1 << 8, 1 << 16);
+BENCHMARK(BM_InsertErase<true>)->Range(1 << 8, 1 << 16);
@@ -0,0 +1,197 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "skip_list.hpp"
+
+namespace {
+
+std::vector<int> shuffled_keys(std::size_t count) {
+  std::vector<int> keys(count);
+  std::iota(keys.begin(), keys.end(), 0);
+  std::mt19937 gen(42);
+  std::shuffle(keys.begin(), keys.end(), gen);
+  return keys;
+}
+
+template <typename SkipList> void BM_Emplace(benchmark::State &state) {
+  const auto keys = shuffled_keys(static_cast<std::size_t>(state.range(0)));
+  std::size_t visited_sum = 0u;
+  for (auto _ : state) {
+    SkipList sl;
+    std::seed_seq seed{7};
+    sl.set_seed(seed);
+    for (auto key : keys) {
+      std::size_t visited = 0u;
+      sl.emplace(key, &visited);
+      visited_sum += visited;
+    }
+    benchmark::DoNotOptimize(sl.size());
+  }
+  const auto inserts = static_cast<double>(keys.size());
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<std::int64_t>(keys.size()));
+  state.counters["visited"] = benchmark::Counter(
+      static_cast<double>(visited_sum) / inserts,
+      benchmark::Counter::kAvgIterations);
+}
+
+// Times every insertion on its own, the tail of the latency distribution shows
+// inserts that write more than the links of their own tower.
+template <typename SkipList> void BM_InsertLatency(benchmark::State &state) {
+  const auto keys = shuffled_keys(static_cast<std::size_t>(state.range(0)));
+  constexpr std::size_t max_samples = 1u << 22;
+  std::vector<double> latencies;
+  latencies.reserve(std::min(max_samples, 64u * keys.size()));
+  for (auto _ : state) {
+    state.PauseTiming();
+    SkipList sl;
+    std::seed_seq seed{7};
+    sl.set_seed(seed);
+    state.ResumeTiming();
+    for (auto key : keys) {
+      const auto start = std::chrono::steady_clock::now();
+      sl.emplace(key);
+      const auto stop = std::chrono::steady_clock::now();
+      if (latencies.size() < max_samples) {
+        latencies.push_back(
+            std::chrono::duration<double, std::nano>(stop - start).count());
+      }
+    }
+    benchmark::DoNotOptimize(sl.size());
+  }
+  std::sort(latencies.begin(), latencies.end());
+  const auto percentile = [&](double fraction) {
+    const auto last = static_cast<double>(latencies.size() - 1u);
+    return latencies[static_cast<std::size_t>(fraction * last)];
+  };
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<std::int64_t>(keys.size()));
+  state.counters["p50_ns"] = percentile(0.5);
+  state.counters["p99_ns"] = percentile(0.99);
+  state.counters["p99.9_ns"] = percentile(0.999);
+  state.counters["max_ns"] = latencies.back();
+}
+
+template <typename SkipList> void BM_Find(benchmark::State &state) {
+  const auto keys = shuffled_keys(static_cast<std::size_t>(state.range(0)));
+  SkipList sl;
+  std::seed_seq seed{7};
+  sl.set_seed(seed);
+  for (auto key : keys) {
+    sl.emplace(key);
+  }
+  for (auto _ : state) {
+    for (auto key : keys) {
+      benchmark::DoNotOptimize(sl.find(key));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<std::int64_t>(keys.size()));
+}
+
+// Erases and re-inserts every key once per iteration, the size stays constant.
+template <typename SkipList> void BM_Churn(benchmark::State &state) {
+  const auto keys = shuffled_keys(static_cast<std::size_t>(state.range(0)));
+  SkipList sl;
+  std::seed_seq seed{7};
+  sl.set_seed(seed);
+  for (auto key : keys) {
+    sl.emplace(key);
+  }
+  for (auto _ : state) {
+    for (auto key : keys) {
+      sl.erase(key);
+      sl.emplace(key);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<std::int64_t>(keys.size()));
+}
+
+// Inserts ascending runs of 32 keys at random places of a list of even keys,
+// each key of a run with the previous insertion as the hint or without hint.
+template <typename SkipList, bool Hinted>
+void BM_ClusteredInsert(benchmark::State &state) {
+  const auto count{static_cast<int>(state.range(0))};
+  SkipList base;
+  std::seed_seq seed{7};
+  base.set_seed(seed);
+  for (int key = 0; key < 2 * count; key += 2) {
+    base.insert(base.end(), key);
+  }
+  std::vector<int> keys;
+  std::mt19937 gen(42);
+  std::uniform_int_distribution<int> start(0, count - 32);
+  for (int run = 0; run < count / 32; ++run) {
+    const auto first{2 * start(gen) + 1};
+    for (int key = first; key < first + 64; key += 2) {
+      keys.push_back(key);
+    }
+  }
+  for (auto _ : state) {
+    state.PauseTiming();
+    SkipList sl(base);
+    state.ResumeTiming();
+    auto hint{sl.end()};
+    for (std::size_t i = 0u; i < keys.size(); ++i) {
+      if constexpr (Hinted) {
+        hint = sl.insert(i % 32u == 0u ? sl.end() : hint, keys[i]);
+      } else {
+        sl.insert(keys[i]);
+      }
+    }
+    benchmark::DoNotOptimize(sl.size());
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<std::int64_t>(keys.size()));
+}
+
+template <std::size_t MaxNodeSize>
+using geometric_list = sl::skip_list<int, std::less<int>,
+                                     sl::DEFAULT_PROBABILITY, MaxNodeSize>;
+
+template <std::size_t MaxNodeSize>
+using uniform_list =
+    sl::skip_list<int, std::less<int>, sl::DEFAULT_PROBABILITY, MaxNodeSize,
+                  std::allocator<int>,
+                  sl::uniform_level_generator<MaxNodeSize>>;
+
+template <std::size_t MaxNodeSize>
+using pooled_list =
+    sl::skip_list<int, std::less<int>, sl::DEFAULT_PROBABILITY, MaxNodeSize,
+                  std::allocator<int>,
+                  sl::geometric_level_generator<sl::DEFAULT_PROBABILITY,
+                                                MaxNodeSize>,
+                  sl::slab_node_pool<>>;
+
+} // namespace
+
+BENCHMARK(BM_Emplace<geometric_list<5>>)->Range(1 << 8, 1 << 14);
+BENCHMARK(BM_Emplace<geometric_list<16>>)->Range(1 << 8, 1 << 14);
+BENCHMARK(BM_Emplace<uniform_list<5>>)->Range(1 << 8, 1 << 14);
+BENCHMARK(BM_Emplace<uniform_list<16>>)->Range(1 << 8, 1 << 14);
+
+BENCHMARK(BM_InsertLatency<geometric_list<16>>)->Range(1 << 8, 1 << 16);
+BENCHMARK(BM_InsertLatency<uniform_list<16>>)->Range(1 << 8, 1 << 16);
+
+BENCHMARK(BM_Find<geometric_list<5>>)->Range(1 << 8, 1 << 14);
+BENCHMARK(BM_Find<geometric_list<16>>)->Range(1 << 8, 1 << 14);
+BENCHMARK(BM_Find<uniform_list<5>>)->Range(1 << 8, 1 << 14);
+BENCHMARK(BM_Find<uniform_list<16>>)->Range(1 << 8, 1 << 14);
+
+BENCHMARK(BM_Emplace<pooled_list<5>>)->Range(1 << 8, 1 << 14);
+BENCHMARK(BM_Emplace<pooled_list<16>>)->Range(1 << 8, 1 << 14);
+
+BENCHMARK(BM_Churn<geometric_list<16>>)->Range(1 << 8, 1 << 14);
+BENCHMARK(BM_Churn<pooled_list<16>>)->Range(1 << 8, 1 << 14);
+
+BENCHMARK(BM_ClusteredInsert<geometric_list<16>, false>)
+    ->Range(1 << 8, 1 << 14);
+BENCHMARK(BM_ClusteredInsert<geometric_list<16>, true>)
+    ->Range(1 << 8, 1 << 14);
@@ -1,15 +1,28 @@
 #ifndef SKIP_LIST_SKIP_LIST_HPP_
 #define SKIP_LIST_SKIP_LIST_HPP_
 
+#include <algorithm>
+#include <array>
+#include <bit>
 #include <cassert>
+#include <concepts>
 #include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <functional>
 #include <initializer_list>
+#include <iterator>
 #include <limits>
 #include <memory>
+#include <memory_resource>
+#include <new>
 #include <optional>
 #include <random>
+#include <span>
+#include <stdexcept>
 #include <string_view>
+#include <tuple>
+#include <utility>
 
 namespace sl {
 
@@ -19,58 +32,660 @@ static constexpr std::size_t DEFAULT_MAX_NODE_SIZE{5u};
 
 static constexpr int DEFAULT_PROBABILITY{50};
 
-template <typename T, std::size_t MaxNodeSize = DEFAULT_MAX_NODE_SIZE>
-struct node {
+namespace detail {
+
+template <typename T>
+inline constexpr std::size_t node_alignment =
+    alignof(T) > alignof(void *) ? alignof(T) : alignof(void *);
+
+// Allocation unit of a node, the node header and its tower are allocated as
+// an array of these, so the allocator is always asked for properly aligned
+// memory.
+template <std::size_t Alignment> struct alignas(Alignment) node_storage {
+  std::array<std::byte, Alignment> m_bytes;
+};
+
+// Comparators that declare `is_transparent` compare values with keys of any
+// type, as in the heterogeneous lookup of std::set.
+template <typename Compare>
+concept transparent_comparator = requires { typename Compare::is_transparent; };
+
+// Orders map entries by key alone, and entries with bare keys, so a map
+// looks entries up by key without building one.
+template <typename Key, typename Value, typename Compare> struct entry_compare {
+  using is_transparent = void;
+  using entry_type = std::pair<const Key, Value>;
+
+  bool operator()(const entry_type &lhs, const entry_type &rhs) const {
+    return m_compare(lhs.first, rhs.first);
+  }
+  template <typename K>
+    requires(!std::same_as<K, entry_type>)
+  bool operator()(const entry_type &lhs, const K &rhs) const {
+    return m_compare(lhs.first, rhs);
+  }
+  template <typename K>
+    requires(!std::same_as<K, entry_type>)
+  bool operator()(const K &lhs, const entry_type &rhs) const {
+    return m_compare(lhs, rhs.first);
+  }
+
+  [[no_unique_address]] Compare m_compare;
+};
+
+template <typename Allocator, typename T>
+concept constructs_elements = requires(Allocator &alloc, T *ptr,
+                                       const T &value) {
+  alloc.construct(ptr, value);
+};
+
+struct set_algebra;
+
+inline void prefetch(const void *address) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+  __builtin_prefetch(address);
+#else
+  static_cast<void>(address);
+#endif
+}
+
+} // namespace detail
+
+// Node header is followed in the same allocation by exactly `capacity()`
+// forward pointers, so a node never pays for levels it does not have.
+// `Indexed` nodes store after them the width of every link, the number of
+// level 0 steps it skips. `Bidirectional` nodes also link back to the
+// previous node on level 0.
+// Nodes can only be built in storage of `storage_size` units through
+// `construct` or `clone`, and torn down through `destruct` or `destroy`.
+template <typename T, std::size_t MaxNodeSize = DEFAULT_MAX_NODE_SIZE,
+          bool Indexed = false, bool Bidirectional = false>
+struct alignas(detail::node_alignment<T>) node {
   using size_type = std::size_t;
+  using level_type = std::uint8_t;
+  using storage_type = detail::node_storage<detail::node_alignment<T>>;
+
+  static_assert(MaxNodeSize <= std::numeric_limits<level_type>::max());
+  static_assert(alignof(size_type) <= alignof(node *));
+
+  static constexpr size_type max_capacity{MaxNodeSize};
+  static constexpr bool indexed{Indexed};
+  static constexpr bool bidirectional{Bidirectional};
+
+  node(const node &) = delete;
+  node(node &&) = delete;
+  node &operator=(const node &) = delete;
+  node &operator=(node &&) = delete;
+  // The value is destroyed by `destroy`.
+  ~node() {}
+
+  // Number of `storage_type` units needed by a node with `capacity` levels.
+  static constexpr size_type storage_size(size_type capacity) noexcept {
+    const auto link_size{sizeof(node *) + (Indexed ? sizeof(size_type) : 0U)};
+    const auto bytes = sizeof(node) + capacity * link_size;
+    return (bytes + sizeof(storage_type) - 1U) / sizeof(storage_type);
+  }
 
-  template <typename U, typename Generator>
-  node(U &&a_value, Generator &gen) : m_value(std::forward<U>(a_value)) {
-    std::uniform_int_distribution<size_type> uniform_dist(1U, MaxNodeSize);
-    m_capacity = uniform_dist(gen);
+  template <typename StorageAllocator>
+  static void destroy(StorageAllocator &alloc, node *node_ptr) noexcept {
+    using traits = std::allocator_traits<StorageAllocator>;
+    const auto units = storage_size(node_ptr->capacity());
+    traits::deallocate(alloc, destruct(alloc, node_ptr), units);
   }
 
-  void fill_nexts() {
-    auto next = m_nexts[0U];
-    size_type i = 1U;
-    while (next && i < capacity()) {
-      while (i < next->capacity() && i < capacity()) {
-        m_nexts[i++] = next;
-      }
-      next = (i < next->capacity()) ? next->m_nexts[i] : next->m_nexts[0U];
+  // Builds a node in `storage_size(capacity)` units of already allocated
+  // storage, the storage is left to the caller if the value throws. The
+  // value is constructed through `alloc`, so allocators that construct
+  // elements themselves (e.g. std::pmr) are honoured for the value too.
+  template <typename StorageAllocator, typename... Args>
+  static node *construct(StorageAllocator &alloc, storage_type *storage,
+                         size_type capacity, Args &&...args) {
+    assert(capacity >= 1U && capacity <= MaxNodeSize);
+    using traits = std::allocator_traits<StorageAllocator>;
+    auto *result = ::new (static_cast<void *>(storage)) node(capacity);
+    try {
+      traits::construct(alloc, std::addressof(result->get()),
+                        std::forward<Args>(args)...);
+    } catch (...) {
+      result->~node();
+      throw;
     }
+    return result;
   }
 
-  void clear_nexts() {
-    for (auto &next : m_nexts) {
-      next = nullptr;
+  // Builds a copy of `source`, with the same height and no links, in
+  // `storage_size(source.capacity())` units of already allocated storage.
+  // Trivially copyable values are copied bytewise unless the allocator
+  // constructs elements itself.
+  template <typename StorageAllocator>
+  static node *clone(StorageAllocator &alloc, storage_type *storage,
+                     const node &source) {
+    if constexpr (std::is_trivially_copyable_v<T> &&
+                  !detail::constructs_elements<StorageAllocator, T>) {
+      auto *result =
+          ::new (static_cast<void *>(storage)) node(source.capacity());
+      std::memcpy(static_cast<void *>(std::addressof(result->get())),
+                  std::addressof(source.get()), sizeof(T));
+      return result;
+    } else {
+      return construct(alloc, storage, source.capacity(), source.get());
     }
   }
 
+  // Destroys the node and returns its storage without releasing it.
+  template <typename StorageAllocator>
+  static storage_type *destruct(StorageAllocator &alloc,
+                                node *node_ptr) noexcept {
+    using traits = std::allocator_traits<StorageAllocator>;
+    traits::destroy(alloc, std::addressof(node_ptr->get()));
+    node_ptr->~node();
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    return reinterpret_cast<storage_type *>(node_ptr);
+  }
+
+  // Builds a full height node with no value in `storage_size(MaxNodeSize)`
+  // units of storage, the header a list keeps in front of its first node.
+  // It owns nothing, so it is never destroyed.
+  static node *construct_header(storage_type *storage) noexcept {
+    return ::new (static_cast<void *>(storage)) node(MaxNodeSize);
+  }
+
+  void clear_nexts() { std::fill_n(nexts(), capacity(), nullptr); }
+
   size_type capacity() const noexcept { return m_capacity; }
 
   node *&get_next(size_type index) noexcept {
-    assert(index < MaxNodeSize);
-    return m_nexts[index];
+    assert(index < capacity());
+    return nexts()[index];
   }
   const node *const &get_next(size_type index) const noexcept {
-    assert(index < MaxNodeSize);
-    return m_nexts[index];
+    assert(index < capacity());
+    return nexts()[index];
+  }
+
+  node *&get_prev() noexcept
+    requires Bidirectional
+  {
+    return m_prev;
+  }
+  const node *get_prev() const noexcept
+    requires Bidirectional
+  {
+    return m_prev;
   }
+
+  // Number of nodes from this one to `get_next(index)`, or to the end of the
+  // list past the last node.
+  size_type &get_width(size_type index) noexcept
+    requires Indexed
+  {
+    assert(index < capacity());
+    return widths()[index];
+  }
+  size_type get_width(size_type index) const noexcept
+    requires Indexed
+  {
+    assert(index < capacity());
+    return widths()[index];
+  }
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-union-access)
   T &get() noexcept { return m_value; }
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-union-access)
   const T &get() const noexcept { return m_value; }
 
   auto rbegin() noexcept {
-    return m_nexts.rbegin() + (MaxNodeSize - capacity());
+    return std::reverse_iterator<node **>(nexts() + capacity());
   }
 
-  auto rend() noexcept { return m_nexts.rend(); }
+  auto rend() noexcept { return std::reverse_iterator<node **>(nexts()); }
 
 private:
-  std::array<node *, MaxNodeSize> m_nexts{nullptr};
-  T m_value;
-  size_type m_capacity{0U};
+  explicit node(size_type capacity)
+      : m_capacity(static_cast<level_type>(capacity)) {
+    std::uninitialized_fill_n(nexts(), capacity, nullptr);
+    if constexpr (Indexed) {
+      std::uninitialized_fill_n(widths(), capacity, size_type{0U});
+    }
+  }
+
+  // NOLINTBEGIN(cppcoreguidelines-pro-type-reinterpret-cast)
+  node **nexts() noexcept {
+    return std::launder(reinterpret_cast<node **>(
+        reinterpret_cast<std::byte *>(this) + sizeof(node)));
+  }
+  const node *const *nexts() const noexcept {
+    return std::launder(reinterpret_cast<const node *const *>(
+        reinterpret_cast<const std::byte *>(this) + sizeof(node)));
+  }
+  size_type *widths() noexcept {
+    return std::launder(reinterpret_cast<size_type *>(
+        reinterpret_cast<std::byte *>(nexts() + capacity())));
+  }
+  const size_type *widths() const noexcept {
+    return std::launder(reinterpret_cast<const size_type *>(
+        reinterpret_cast<const std::byte *>(nexts() + capacity())));
+  }
+  // NOLINTEND(cppcoreguidelines-pro-type-reinterpret-cast)
+
+  struct no_prev {};
+
+  union {
+    T m_value;
+  };
+  level_type m_capacity;
+  [[no_unique_address]] std::conditional_t<Bidirectional, node *, no_prev>
+      m_prev{};
+};
+
+// Level generation policies. A policy is called with the list's random
+// engine and returns the height of the next node, in [1, MaxNodeSize].
+
+// Every level above the first is kept with probability ProbabilityInt / 100,
+// which gives the expected O(log n) search path of a skip list.
+template <int ProbabilityInt = DEFAULT_PROBABILITY,
+          std::size_t MaxNodeSize = DEFAULT_MAX_NODE_SIZE>
+struct geometric_level_generator {
+  static_assert(ProbabilityInt >= 0 && ProbabilityInt < 100);
+  static_assert(MaxNodeSize >= 1U);
+
+  template <typename Generator>
+  std::size_t operator()(Generator &gen) const {
+    using result_type = typename Generator::result_type;
+    constexpr auto range =
+        static_cast<std::uint64_t>(Generator::max() - Generator::min());
+    constexpr auto threshold = static_cast<result_type>(
+        range / 100U * static_cast<std::uint64_t>(ProbabilityInt));
+    std::size_t level{1U};
+    while (level < MaxNodeSize &&
+           static_cast<result_type>(gen() - Generator::min()) < threshold) {
+      ++level;
+    }
+    return level;
+  }
+};
+
+// Every height is equally likely, kept for structures that want towers
+// independent of ProbabilityInt.
+template <std::size_t MaxNodeSize = DEFAULT_MAX_NODE_SIZE>
+struct uniform_level_generator {
+  static_assert(MaxNodeSize >= 1U);
+
+  template <typename Generator>
+  std::size_t operator()(Generator &gen) const {
+    std::uniform_int_distribution<std::size_t> uniform_dist(1U, MaxNodeSize);
+    return uniform_dist(gen);
+  }
+};
+
+// Node pool policies. The list gets node storage from its pool, the pool gets
+// memory from the list's allocator, which is passed to every call.
+
+// Every node is a separate allocator call, nothing is kept around.
+struct no_node_pool {
+  template <typename Node, typename StorageAllocator> class pool {
+  public:
+    using size_type = std::size_t;
+    using storage_type = typename Node::storage_type;
+    using traits = std::allocator_traits<StorageAllocator>;
+
+    // `reset` can drop every node at once.
+    static constexpr bool recycles = false;
+
+    storage_type *allocate(StorageAllocator &alloc, size_type capacity) {
+      return traits::allocate(alloc, Node::storage_size(capacity));
+    }
+
+    void deallocate(StorageAllocator &alloc, storage_type *storage,
+                    size_type capacity) noexcept {
+      traits::deallocate(alloc, storage, Node::storage_size(capacity));
+    }
+
+    template <typename Counts>
+    void reserve(StorageAllocator &, const Counts &) {}
+    void adopt(pool &) noexcept {}
+    void shrink_to_fit(StorageAllocator &) noexcept {}
+    void release(StorageAllocator &) noexcept {}
+    void reset() noexcept {}
+    void swap(pool &) noexcept {}
+  };
+};
+
+// Nodes are carved out of slabs of `NodesPerSlab` nodes, one set of slabs per
+// tower height, and freed nodes are recycled through intrusive free lists.
+template <std::size_t NodesPerSlab = 64U> struct slab_node_pool {
+  static_assert(NodesPerSlab >= 1U);
+
+  template <typename Node, typename StorageAllocator> class pool {
+  public:
+    using size_type = std::size_t;
+    using storage_type = typename Node::storage_type;
+    using traits = std::allocator_traits<StorageAllocator>;
+
+    static constexpr bool recycles = true;
+
+    pool() = default;
+    pool(const pool &) = delete;
+    pool &operator=(const pool &) = delete;
+    pool(pool &&) = delete;
+    pool &operator=(pool &&) = delete;
+    // Slabs must be given back with `release`, the pool does not own an
+    // allocator.
+    ~pool() { assert(empty()); }
+
+    storage_type *allocate(StorageAllocator &alloc, size_type capacity) {
+      auto &slabs{bucket(capacity)};
+      if (slabs.m_free != nullptr) {
+        auto *slot{slabs.m_free};
+        slabs.m_free = slot->m_next;
+        --slabs.m_free_count;
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        return reinterpret_cast<storage_type *>(slot);
+      }
+      if (slabs.m_used == nullptr || slabs.m_used->m_bumped == NodesPerSlab) {
+        slab *next{slabs.m_spare};
+        if (next != nullptr) {
+          slabs.m_spare = next->m_next;
+        } else {
+          next = new_slab(alloc, capacity);
+        }
+        next->m_next = slabs.m_used;
+        slabs.m_used = next;
+      }
+      return slot_at(slabs.m_used, capacity, slabs.m_used->m_bumped++);
+    }
+
+    void deallocate(StorageAllocator &, storage_type *storage,
+                    size_type capacity) noexcept {
+      auto &slabs{bucket(capacity)};
+      slabs.m_free = ::new (static_cast<void *>(storage)) free_slot{
+          slabs.m_free};
+      ++slabs.m_free_count;
+    }
+
+    // Makes sure that `counts[level - 1]` nodes of every height can be
+    // allocated without calling the allocator.
+    template <typename Counts>
+    void reserve(StorageAllocator &alloc, const Counts &counts) {
+      for (size_type capacity{1U}; capacity <= counts.size(); ++capacity) {
+        auto &slabs{bucket(capacity)};
+        size_type available{slabs.m_free_count};
+        if (slabs.m_used != nullptr) {
+          available += NodesPerSlab - slabs.m_used->m_bumped;
+        }
+        for (auto *it{slabs.m_spare}; it != nullptr; it = it->m_next) {
+          available += NodesPerSlab;
+        }
+        while (available < counts[capacity - 1U]) {
+          auto *spare{new_slab(alloc, capacity)};
+          spare->m_next = slabs.m_spare;
+          slabs.m_spare = spare;
+          available += NodesPerSlab;
+        }
+      }
+    }
+
+    // Takes over every slab of `other`, whose nodes now belong to this pool.
+    // Both pools must use equal allocators.
+    void adopt(pool &other) noexcept {
+      for (size_type capacity{1U}; capacity <= m_buckets.size(); ++capacity) {
+        auto &slabs{bucket(capacity)};
+        auto &others{other.bucket(capacity)};
+        // Only the first used slab may be partly bumped, the rest of the
+        // adopted one is recycled through the free list instead.
+        if (auto *bumped{others.m_used};
+            bumped != nullptr && bumped->m_bumped < NodesPerSlab) {
+          while (bumped->m_bumped < NodesPerSlab) {
+            others.m_free = ::new (static_cast<void *>(
+                slot_at(bumped, capacity, bumped->m_bumped++)))
+                free_slot{others.m_free};
+            ++others.m_free_count;
+          }
+        }
+        if (slabs.m_used == nullptr) {
+          slabs.m_used = others.m_used;
+        } else {
+          splice(slabs.m_used->m_next, others.m_used);
+        }
+        splice(slabs.m_spare, others.m_spare);
+        splice(slabs.m_free, others.m_free);
+        slabs.m_free_count += others.m_free_count;
+        others = bucket_type{};
+      }
+    }
+
+    // Gives back every slab that has no live node.
+    void shrink_to_fit(StorageAllocator &alloc) noexcept {
+      for (size_type capacity{1U}; capacity <= m_buckets.size(); ++capacity) {
+        auto &slabs{bucket(capacity)};
+        release_slabs(alloc, slabs.m_spare, capacity);
+        slabs.m_spare = nullptr;
+        // With both lists in address order every free slot is matched to its
+        // slab in a single sweep.
+        slabs.m_used = sort_by_address(slabs.m_used);
+        slabs.m_free = sort_by_address(slabs.m_free);
+        for (auto *it{slabs.m_used}; it != nullptr; it = it->m_next) {
+          it->m_free = 0U;
+        }
+        auto *current{slabs.m_used};
+        for (auto *slot{slabs.m_free}; slot != nullptr; slot = slot->m_next) {
+          current = owner(current, slot, capacity);
+          ++current->m_free;
+        }
+        current = slabs.m_used;
+        auto **free_link{&slabs.m_free};
+        while (*free_link != nullptr) {
+          current = owner(current, *free_link, capacity);
+          if (current->is_unused()) {
+            *free_link = (*free_link)->m_next;
+            --slabs.m_free_count;
+          } else {
+            free_link = &(*free_link)->m_next;
+          }
+        }
+        slab *bumped{nullptr};
+        auto **slab_link{&slabs.m_used};
+        while (*slab_link != nullptr) {
+          current = *slab_link;
+          if (current->is_unused() || current->m_bumped < NodesPerSlab) {
+            *slab_link = current->m_next;
+            if (current->is_unused()) {
+              release_slab(alloc, current, capacity);
+            } else {
+              bumped = current;
+            }
+          } else {
+            slab_link = &current->m_next;
+          }
+        }
+        if (bumped != nullptr) {
+          bumped->m_next = slabs.m_used;
+          slabs.m_used = bumped;
+        }
+      }
+    }
+
+    // Gives back every slab, no node may be alive.
+    void release(StorageAllocator &alloc) noexcept {
+      for (size_type capacity{1U}; capacity <= m_buckets.size(); ++capacity) {
+        auto &slabs{bucket(capacity)};
+        release_slabs(alloc, slabs.m_used, capacity);
+        release_slabs(alloc, slabs.m_spare, capacity);
+        slabs = bucket_type{};
+      }
+    }
+
+    // Marks every node as free in O(slabs), the nodes must already be dead.
+    void reset() noexcept {
+      for (auto &slabs : m_buckets) {
+        while (slabs.m_used != nullptr) {
+          auto *current{slabs.m_used};
+          slabs.m_used = current->m_next;
+          current->m_bumped = 0U;
+          current->m_next = slabs.m_spare;
+          slabs.m_spare = current;
+        }
+        slabs.m_free = nullptr;
+        slabs.m_free_count = 0U;
+      }
+    }
+
+    void swap(pool &other) noexcept { std::swap(m_buckets, other.m_buckets); }
+
+  private:
+    struct free_slot {
+      free_slot *m_next;
+    };
+
+    struct slab {
+      bool is_unused() const noexcept { return m_free == m_bumped; }
+
+      slab *m_next{nullptr};
+      size_type m_bumped{0U};
+      // Only valid during `shrink_to_fit`.
+      size_type m_free{0U};
+    };
+
+    struct bucket_type {
+      // Slabs with handed out nodes, the first one is being bumped.
+      slab *m_used{nullptr};
+      // Slabs with no node handed out.
+      slab *m_spare{nullptr};
+      free_slot *m_free{nullptr};
+      size_type m_free_count{0U};
+    };
+
+    static constexpr size_type header_size =
+        (sizeof(slab) + sizeof(storage_type) - 1U) / sizeof(storage_type);
+
+    static constexpr size_type slab_size(size_type capacity) noexcept {
+      return header_size + NodesPerSlab * Node::storage_size(capacity);
+    }
+
+    static storage_type *slot_at(slab *owner_slab, size_type capacity,
+                                 size_type index) noexcept {
+      // NOLINTBEGIN(cppcoreguidelines-pro-type-reinterpret-cast)
+      // NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+      return reinterpret_cast<storage_type *>(owner_slab) + header_size +
+             index * Node::storage_size(capacity);
+      // NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+      // NOLINTEND(cppcoreguidelines-pro-type-reinterpret-cast)
+    }
+
+    // Inserts the whole `list` chain at `position`.
+    template <typename Link>
+    static void splice(Link *&position, Link *list) noexcept {
+      if (list == nullptr) {
+        return;
+      }
+      auto *last{list};
+      while (last->m_next != nullptr) {
+        last = last->m_next;
+      }
+      last->m_next = position;
+      position = list;
+    }
+
+    // First slab from `first` on that holds `slot`.
+    static slab *owner(slab *first, const free_slot *slot,
+                       size_type capacity) noexcept {
+      // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+      const auto *address = reinterpret_cast<const storage_type *>(slot);
+      const std::less<const storage_type *> less;
+      while (less(address, slot_at(first, capacity, 0U)) ||
+             !less(address, slot_at(first, capacity, NodesPerSlab))) {
+        first = first->m_next;
+        assert(first != nullptr);
+      }
+      return first;
+    }
+
+    // Bottom-up merge sort of an intrusive singly linked list.
+    template <typename Link>
+    static Link *sort_by_address(Link *first) noexcept {
+      const std::less<const Link *> less;
+      for (size_type width{1U};; width *= 2U) {
+        Link *result{nullptr};
+        Link **tail{&result};
+        size_type merges{0U};
+        while (first != nullptr) {
+          ++merges;
+          Link *lhs{first};
+          Link *rhs{first};
+          size_type lhs_size{0U};
+          while (rhs != nullptr && lhs_size < width) {
+            rhs = rhs->m_next;
+            ++lhs_size;
+          }
+          size_type rhs_size{width};
+          while (lhs_size > 0U || (rhs_size > 0U && rhs != nullptr)) {
+            Link **taken{nullptr};
+            if (lhs_size == 0U) {
+              taken = &rhs;
+              --rhs_size;
+            } else if (rhs_size == 0U || rhs == nullptr || less(lhs, rhs)) {
+              taken = &lhs;
+              --lhs_size;
+            } else {
+              taken = &rhs;
+              --rhs_size;
+            }
+            *tail = *taken;
+            tail = &(*taken)->m_next;
+            *taken = (*taken)->m_next;
+          }
+          first = rhs;
+        }
+        *tail = nullptr;
+        if (merges <= 1U) {
+          return result;
+        }
+        first = result;
+      }
+    }
+
+    static slab *new_slab(StorageAllocator &alloc, size_type capacity) {
+      storage_type *storage = traits::allocate(alloc, slab_size(capacity));
+      return ::new (static_cast<void *>(storage)) slab{};
+    }
+
+    static void release_slab(StorageAllocator &alloc, slab *released,
+                             size_type capacity) noexcept {
+      released->~slab();
+      // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+      traits::deallocate(alloc, reinterpret_cast<storage_type *>(released),
+                         slab_size(capacity));
+    }
+
+    static void release_slabs(StorageAllocator &alloc, slab *first,
+                              size_type capacity) noexcept {
+      while (first != nullptr) {
+        auto *next{first->m_next};
+        release_slab(alloc, first, capacity);
+        first = next;
+      }
+    }
+
+    bucket_type &bucket(size_type capacity) noexcept {
+      assert(capacity >= 1U && capacity <= m_buckets.size());
+      return m_buckets[capacity - 1U];
+    }
+
+    bool empty() const noexcept {
+      return std::all_of(m_buckets.begin(), m_buckets.end(),
+                         [](const bucket_type &slabs) {
+                           return slabs.m_used == nullptr &&
+                                  slabs.m_spare == nullptr;
+                         });
+    }
+
+    std::array<bucket_type, Node::max_capacity> m_buckets{};
+  };
 };
 
+template <typename Key, typename Value, typename Compare, int ProbabilityInt,
+          std::size_t MaxNodeSize, typename Allocator, typename NodePool>
+class skip_map;
+
 // TODO(skiplist):
 // Probability was changed to Int in template, because Bazel use C (clang)
 // compiler to build program And when building with clang, cannot define float
@@ -78,17 +693,50 @@ private:
 template <typename T, typename Compare = std::less<T>,
           int ProbabilityInt = DEFAULT_PROBABILITY,
           std::size_t MaxNodeSize = DEFAULT_MAX_NODE_SIZE,
-          typename Allocator = std::allocator<T>>
+          typename Allocator = std::allocator<T>,
+          typename LevelGenerator =
+              geometric_level_generator<ProbabilityInt, MaxNodeSize>,
+          typename NodePool = no_node_pool, bool Indexed = false,
+          bool Bidirectional = false>
 class skip_list {
 public:
-  using node_type = node<T, MaxNodeSize>;
+  using node_type = node<T, MaxNodeSize, Indexed, Bidirectional>;
 
 private:
   template <typename IteratorValueType = const node_type> class iterator_impl;
-  using allocator_traits = typename std::allocator_traits<
-      Allocator>::template rebind_traits<node_type>;
+  using node_storage_type = typename node_type::storage_type;
   using allocator_rebind = typename std::allocator_traits<
-      Allocator>::template rebind_alloc<node_type>;
+      Allocator>::template rebind_alloc<node_storage_type>;
+  using allocator_traits = std::allocator_traits<allocator_rebind>;
+  using node_pool_type =
+      typename NodePool::template pool<node_type, allocator_rebind>;
+
+  struct node_deleter {
+    skip_list *m_list;
+    void operator()(node_type *node_ptr) const noexcept {
+      m_list->delete_node(node_ptr);
+    }
+  };
+  using node_holder = std::unique_ptr<node_type, node_deleter>;
+  // Last node of every level, used to append nodes in order.
+  using level_tails = std::array<node_type *, MaxNodeSize>;
+  using header_storage =
+      std::array<typename node_type::storage_type,
+                 node_type::storage_size(MaxNodeSize)>;
+  using level_ranks = std::array<std::size_t, MaxNodeSize>;
+  struct no_ranks {};
+
+  // Predecessors of a position, found by a search or kept between the
+  // searches of a batch operation. Only the first `known` levels are filled,
+  // a search from the header fills all of them. Indexed lists also keep the
+  // rank of every predecessor relative to the node the search started from,
+  // the header has rank 0.
+  struct search_path {
+    level_tails preds{};
+    [[no_unique_address]] std::conditional_t<Indexed, level_ranks, no_ranks>
+        ranks{};
+    std::size_t known{0U};
+  };
 
 public:
   static constexpr float Probability =
@@ -96,6 +744,8 @@ public:
   static_assert(Probability >= 0.f && Probability < 1.0f);
   static_assert(MaxNodeSize >= 1U);
   using allocator_type = Allocator;
+  using level_generator_type = LevelGenerator;
+  using node_pool = NodePool;
   using const_iterator = iterator_impl<const node_type>;
   using const_pointer =
       typename std::allocator_traits<Allocator>::const_pointer;
@@ -103,28 +753,113 @@ public:
   using const_reference = const value_type &;
   using difference_type = std::ptrdiff_t;
   using iterator = const_iterator;
+  using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+  using reverse_iterator = const_reverse_iterator;
   using pointer = typename std::allocator_traits<Allocator>::pointer;
   using reference = value_type &;
   using size_type = std::size_t;
 
+  // Owns a node taken out of a list by `extract_node`. `insert` links it into
+  // a list of the same type with an equal allocator without allocating, an
+  // empty handle frees nothing.
+  class node_handle {
+  public:
+    using value_type = T;
+    using allocator_type = Allocator;
+
+    node_handle() noexcept = default;
+    node_handle(const node_handle &) = delete;
+    node_handle(node_handle &&other) noexcept
+        : m_node(std::exchange(other.m_node, nullptr)),
+          m_allocator(std::move(other.m_allocator)) {}
+    node_handle &operator=(const node_handle &) = delete;
+    node_handle &operator=(node_handle &&other) noexcept {
+      if (this != &other) {
+        reset();
+        m_node = std::exchange(other.m_node, nullptr);
+        m_allocator = std::move(other.m_allocator);
+      }
+      return *this;
+    }
+    ~node_handle() { reset(); }
+
+    bool empty() const noexcept { return m_node == nullptr; }
+    explicit operator bool() const noexcept { return !empty(); }
+
+    // The value may be changed, its order is checked again by `insert`.
+    value_type &value() const noexcept {
+      assert(!empty());
+      return m_node->get();
+    }
+
+    allocator_type get_allocator() const {
+      assert(!empty());
+      return allocator_type(*m_allocator);
+    }
+
+    void swap(node_handle &other) noexcept {
+      std::swap(m_node, other.m_node);
+      std::swap(m_allocator, other.m_allocator);
+    }
+
+    friend void swap(node_handle &lhs, node_handle &rhs) noexcept {
+      lhs.swap(rhs);
+    }
+
+  private:
+    friend class skip_list;
+
+    node_handle(node_type *node_ptr, const allocator_rebind &alloc) noexcept
+        : m_node(node_ptr) {
+      if (node_ptr != nullptr) {
+        m_allocator.emplace(alloc);
+      }
+    }
+
+    node_type *release() noexcept {
+      m_allocator.reset();
+      return std::exchange(m_node, nullptr);
+    }
+
+    void reset() noexcept {
+      if (m_node != nullptr) {
+        node_type::destroy(*m_allocator, std::exchange(m_node, nullptr));
+      }
+      m_allocator.reset();
+    }
+
+    node_type *m_node{nullptr};
+    std::optional<allocator_rebind> m_allocator;
+  };
+
   skip_list() = default;
 
   explicit skip_list(const Compare &comp, const Allocator &alloc)
-      : m_comparator(comp), m_allocator(alloc) {}
+      : m_allocator(alloc), m_comparator(comp) {}
+
+  explicit skip_list(const Allocator &alloc) : m_allocator(alloc) {}
 
   skip_list(size_type count, const T &value, const Compare &comp = Compare(),
             const Allocator &alloc = Allocator())
-      : m_comparator(comp), m_allocator(alloc) {
-    for (size_type i{0U}; i < count; ++i) {
-      push(value);
+      : m_allocator(alloc), m_comparator(comp) {
+    try {
+      append_values(count, value);
+    } catch (...) {
+      clear_elements();
+      m_pool.release(m_allocator);
+      throw;
     }
   }
 
   explicit skip_list(size_type count, const Compare &comp = Compare(),
                      const Allocator &alloc = Allocator())
-      : m_comparator(comp), m_allocator(alloc) {
-    for (size_type i{0U}; i < count; ++i) {
-      push(T{});
+      : m_allocator(alloc), m_comparator(comp) {
+    try {
+      append_values(count);
+    } catch (...) {
+      clear_elements();
+      m_pool.release(m_allocator);
+      throw;
     }
   }
 
@@ -133,80 +868,140 @@ public:
                              void>)
   skip_list(InputIt first, InputIt last, const Allocator &alloc = Allocator())
       : m_allocator(alloc) {
-    std::copy(first, last, std::inserter(*this, begin()));
+    try {
+      build(first, last);
+    } catch (...) {
+      clear_elements();
+      m_pool.release(m_allocator);
+      throw;
+    }
   }
 
   skip_list(const skip_list &other, const Allocator &alloc)
-      : m_allocator(alloc) {
-    *this = other;
+      : m_allocator(alloc), m_comparator(other.m_comparator),
+        m_generator(other.m_generator),
+        m_level_generator(other.m_level_generator) {
+    try {
+      copy_elements(other);
+    } catch (...) {
+      clear_elements();
+      m_pool.release(m_allocator);
+      throw;
+    }
   }
 
-  skip_list(const skip_list &other) : skip_list(other, Allocator{}) {}
-
-  skip_list(skip_list &&other, const Allocator &alloc) noexcept
-      : m_allocator(alloc) {
-    *this = std::move(other);
+  skip_list(const skip_list &other)
+      : skip_list(other, std::allocator_traits<Allocator>::
+                             select_on_container_copy_construction(
+                                 other.get_allocator())) {}
+
+  skip_list(skip_list &&other, const Allocator &alloc)
+      : m_allocator(alloc), m_comparator(other.m_comparator),
+        m_generator(other.m_generator),
+        m_level_generator(other.m_level_generator) {
+    if constexpr (allocator_traits::is_always_equal::value) {
+      steal_elements(other);
+    } else if (m_allocator == other.m_allocator) {
+      steal_elements(other);
+    } else {
+      move_elements(other);
+    }
   }
 
   skip_list(skip_list &&other) noexcept
-      : skip_list(std::move(other), Allocator{}) {}
+      : m_allocator(std::move(other.m_allocator)),
+        m_comparator(std::move(other.m_comparator)),
+        m_generator(std::move(other.m_generator)),
+        m_level_generator(std::move(other.m_level_generator)) {
+    steal_elements(other);
+  }
 
   skip_list(std::initializer_list<T> init, const Allocator &alloc = Allocator())
       : skip_list(init.begin(), init.end(), alloc) {}
 
-  ~skip_list() noexcept { clear_elements(); }
+  ~skip_list() noexcept {
+    clear_elements();
+    m_pool.release(m_allocator);
+  }
 
   skip_list &operator=(const skip_list &other) {
     if (this == &other) {
       return *this;
     }
-    clear();
+    clear_elements();
+    if constexpr (allocator_traits::propagate_on_container_copy_assignment::
+                      value) {
+      m_pool.release(m_allocator);
+      m_allocator = other.m_allocator;
+    }
     m_comparator = other.m_comparator;
     m_generator = other.m_generator;
-    m_allocator = other.m_allocator;
-    std::copy(other.begin(), other.end(), std::inserter(*this, begin()));
+    m_level_generator = other.m_level_generator;
+    copy_elements(other);
     return *this;
   }
 
-  skip_list &operator=(skip_list &&other) noexcept {
+  skip_list &operator=(skip_list &&other) noexcept(
+      allocator_traits::propagate_on_container_move_assignment::value ||
+      allocator_traits::is_always_equal::value) {
     if (this == &other) {
       return *this;
     }
-    m_head = other.m_head;
-    other.m_head = nullptr;
-    m_tail = other.m_tail;
-    other.m_tail = nullptr;
-    m_size = other.m_size;
-    other.m_size = 0U;
+    clear_elements();
     m_comparator = std::move(other.m_comparator);
     m_generator = std::move(other.m_generator);
-    m_allocator = std::move(other.m_allocator);
+    m_level_generator = std::move(other.m_level_generator);
+    if constexpr (allocator_traits::propagate_on_container_move_assignment::
+                      value) {
+      m_pool.release(m_allocator);
+      m_allocator = std::move(other.m_allocator);
+      steal_elements(other);
+    } else if constexpr (allocator_traits::is_always_equal::value) {
+      m_pool.release(m_allocator);
+      steal_elements(other);
+    } else if (m_allocator == other.m_allocator) {
+      m_pool.release(m_allocator);
+      steal_elements(other);
+    } else {
+      move_elements(other);
+    }
     return *this;
   }
 
+  // Allocators are swapped only if they propagate on swap, otherwise they
+  // must compare equal.
   void swap(skip_list &other) noexcept {
     if (this == &other) {
       return;
     }
-    std::swap(m_head, other.m_head);
+    swap_headers(other);
     std::swap(m_tail, other.m_tail);
     std::swap(m_size, other.m_size);
-    std::swap(m_allocator, other.m_allocator);
+    if constexpr (allocator_traits::propagate_on_container_swap::value) {
+      std::swap(m_allocator, other.m_allocator);
+    } else if constexpr (!allocator_traits::is_always_equal::value) {
+      assert(m_allocator == other.m_allocator);
+    }
     std::swap(m_comparator, other.m_comparator);
     std::swap(m_generator, other.m_generator);
+    std::swap(m_level_generator, other.m_level_generator);
+    m_pool.swap(other.m_pool);
   }
 
+  friend void swap(skip_list &lhs, skip_list &rhs) noexcept { lhs.swap(rhs); }
+
+  // The set algebra below the class builds its result with `combine`.
+  friend struct detail::set_algebra;
+
   skip_list &operator=(std::initializer_list<T> ilist) {
     clear_elements();
-    std::copy(ilist.begin(), ilist.end(), std::inserter(*this, begin()));
+    build(ilist.begin(), ilist.end());
     return *this;
   }
 
   void assign(size_type count, const T &value) {
     clear_elements();
-    while (count-- > 0U) {
-      push(value);
-    }
+    append_values(count, value);
   }
 
   template <class InputIt>
@@ -214,18 +1009,20 @@ public:
                              void>)
   void assign(InputIt first, InputIt last) {
     clear_elements();
-    std::copy(first, last, std::inserter(*this, begin()));
+    build(first, last);
   }
 
   void assign(std::initializer_list<T> ilist) {
     assign(ilist.begin(), ilist.end());
   }
 
-  allocator_type get_allocator() const noexcept { return m_allocator; }
+  allocator_type get_allocator() const noexcept {
+    return allocator_type(m_allocator);
+  }
 
   const_reference front() const noexcept {
-    assert(m_head != nullptr);
-    return m_head->get();
+    assert(first_node() != nullptr);
+    return first_node()->get();
   };
 
   const_reference back() const noexcept {
@@ -233,11 +1030,35 @@ public:
     return m_tail->get();
   }
 
-  iterator begin() const noexcept { return iterator(m_head); }
-  const_iterator cbegin() const noexcept { return const_iterator{m_head}; }
+  iterator begin() const noexcept { return make_iterator(first_node()); }
+  const_iterator cbegin() const noexcept {
+    return make_iterator(first_node());
+  }
+
+  iterator end() const noexcept { return make_iterator(nullptr); }
+  const_iterator cend() const noexcept { return make_iterator(nullptr); }
 
-  iterator end() const noexcept { return iterator{nullptr}; }
-  const_iterator cend() const noexcept { return const_iterator{nullptr}; }
+  reverse_iterator rbegin() const noexcept
+    requires Bidirectional
+  {
+    return reverse_iterator{end()};
+  }
+  const_reverse_iterator crbegin() const noexcept
+    requires Bidirectional
+  {
+    return const_reverse_iterator{cend()};
+  }
+
+  reverse_iterator rend() const noexcept
+    requires Bidirectional
+  {
+    return reverse_iterator{begin()};
+  }
+  const_reverse_iterator crend() const noexcept
+    requires Bidirectional
+  {
+    return const_reverse_iterator{cbegin()};
+  }
 
   size_type size() const noexcept { return m_size; };
   bool empty() const noexcept { return size() == 0U; };
@@ -247,84 +1068,40 @@ public:
 
   void clear() {
     m_comparator = Compare();
-    m_allocator = Allocator();
     m_generator = std::mt19937{std::random_device{}()};
     clear_elements();
   }
 
-  template <typename U>
-  iterator emplace(U &&value, size_type *visited_nodes_counter = nullptr) {
-    if (visited_nodes_counter) {
-      *visited_nodes_counter = 0U;
-    }
-    auto new_node = create_node(std::forward<U>(value));
-    ++m_size;
-    if (m_head == nullptr) {
-      m_head = new_node;
-      m_tail = m_head;
-      return iterator(m_head);
-    }
-    if (m_head == m_tail) {
-      if (m_comparator(new_node->get(), m_head->get())) {
-        m_head = new_node;
-        m_tail->clear_nexts();
-      } else {
-        m_tail = new_node;
-        m_head->clear_nexts();
-      }
-      for (size_type i{0U}; i < m_head->capacity() && i < m_tail->capacity();
-           ++i) {
-        m_head->get_next(i) = m_tail;
-      }
-      return iterator(new_node);
-    };
-    if (m_comparator(new_node->get(), m_head->get())) {
-      new_node->get_next(0U) = m_head;
-      std::swap(m_head, new_node);
-      m_head->fill_nexts();
-      return iterator(m_head);
-    }
-    bool found_place{false};
-    node_type *nd{m_head};
-    size_type visited{0U};
-    while (found_place == false) {
-      bool looped{false};
-      auto level{static_cast<difference_type>(nd->capacity())};
-      for (auto it{nd->rbegin()}; it != nd->rend(); ++it, --level) {
-        if (*it == nullptr) {
-          if (new_node->capacity() >= level) {
-            *it = new_node;
-          }
-          continue;
-        }
-        if (m_comparator((*it)->get(), new_node->get())) {
-          nd = *it;
-          looped = true;
-          break;
-        } else if (level > 1 && new_node->capacity() >= level) {
-          nd->get_next(static_cast<size_type>(level - 1)) = new_node;
-        }
-      }
-      if (looped == false) {
-        found_place = true;
+  // With a recycling node pool, makes room for `count` more elements so the
+  // next `count` insertions do not call the allocator. The heights of those
+  // nodes are drawn ahead from a copy of the random engine.
+  void reserve(size_type count) {
+    if constexpr (node_pool_type::recycles) {
+      std::array<size_type, MaxNodeSize> heights{};
+      auto generator{m_generator};
+      auto level_generator{m_level_generator};
+      while (count-- > 0U) {
+        ++heights[random_capacity(level_generator, generator) - 1U];
       }
-      ++visited;
-    }
-    if (visited_nodes_counter) {
-      *visited_nodes_counter = visited;
-    }
-    if (nd == m_tail) {
-      m_tail->get_next(0U) = new_node;
-      m_tail->fill_nexts();
-      std::swap(m_tail, new_node);
-      return iterator(m_tail);
+      m_pool.reserve(m_allocator, heights);
     }
+  }
 
-    new_node->get_next(0U) = nd->get_next(0U);
-    new_node->fill_nexts();
-    nd->get_next(0U) = new_node;
-    nd->fill_nexts();
-    return iterator(new_node);
+  // Gives back node pool memory that holds no element.
+  void shrink_to_fit() noexcept { m_pool.shrink_to_fit(m_allocator); }
+
+  template <typename U>
+  iterator emplace(U &&value, size_type *visited_nodes_counter = nullptr) {
+    return insert_node(create_node(std::forward<U>(value)),
+                       visited_nodes_counter);
+  }
+
+  // Builds the element from `args` inside its node, whose height is drawn
+  // before the node is allocated, so the element is never moved.
+  template <typename... Args>
+    requires std::constructible_from<T, Args &&...>
+  iterator emplace(Args &&...args) {
+    return insert_node(create_node(std::forward<Args>(args)...), nullptr);
   }
 
   void push(std::initializer_list<T> ilist) {
@@ -349,12 +1126,37 @@ public:
     return emplace(std::forward<U>(value), visited_nodes_counter);
   }
 
-  template <typename InputIt, typename U>
-    requires(!std::is_same_v<typename std::iterator_traits<InputIt>::value_type,
-                             void>)
-  iterator insert(InputIt, U &&value,
+  // Inserts before the elements equivalent to `value`, as `insert` does,
+  // searching forward from `hint` in O(log d) for a distance d. Levels of the
+  // new tower taller than any node on that path are searched from the
+  // header. `end()` is a hint for appending after the last element. A hint
+  // that does not go before `value` is ignored and the search starts from
+  // the header.
+  template <typename U>
+    requires std::constructible_from<T, U &&>
+  iterator insert(const_iterator hint, U &&value,
                   size_type *visited_nodes_counter = nullptr) {
-    return emplace(std::forward<U>(value), visited_nodes_counter);
+    return emplace_hint(hint, std::forward<U>(value), visited_nodes_counter);
+  }
+
+  template <typename U>
+  iterator emplace_hint(const_iterator hint, U &&value,
+                        size_type *visited_nodes_counter = nullptr) {
+    if (visited_nodes_counter) {
+      *visited_nodes_counter = 0U;
+    }
+    auto *finger{hint == end() ? m_tail : to_node(hint)};
+    return insert_node_from<false>(finger,
+                                   create_node(std::forward<U>(value)),
+                            visited_nodes_counter);
+  }
+
+  template <typename... Args>
+    requires std::constructible_from<T, Args &&...>
+  iterator emplace_hint(const_iterator hint, Args &&...args) {
+    auto *finger{hint == end() ? m_tail : to_node(hint)};
+    return insert_node_from<false>(
+        finger, create_node(std::forward<Args>(args)...), nullptr);
   }
 
   template <typename InputIt>
@@ -367,20 +1169,86 @@ public:
     }
   }
 
+  // Inserts `value` only when no element is equivalent to it, like
+  // `std::set::insert`. The descent that finds the position also finds an
+  // equivalent element, and a node is allocated only once the position is
+  // known to be free.
+  std::pair<iterator, bool> insert_unique(const T &value) {
+    return emplace_unique(value, value);
+  }
+
+  std::pair<iterator, bool> insert_unique(T &&value) {
+    return emplace_unique(value, std::move(value));
+  }
+
+  // Returns the number of inserted elements.
+  template <typename InputIt>
+    requires(!std::is_same_v<typename std::iterator_traits<InputIt>::value_type,
+                             void>)
+  size_type insert_unique(InputIt first, InputIt last) {
+    size_type inserted{0U};
+    for (; first != last; ++first) {
+      inserted += insert_unique(*first).second ? 1U : 0U;
+    }
+    return inserted;
+  }
+
+  // Inserts `[first, last)`, each value before the elements equivalent to
+  // it as `insert` does. The search for a value resumes from the path of the
+  // previous one, which still goes before the node just linked, so a sorted
+  // range costs O(log d) per value for a distance d between them and a
+  // dense range about one merge pass. A value out of order restarts the
+  // search from the header.
+  template <typename InputIt> void insert_sorted(InputIt first, InputIt last) {
+    search_path path{};
+    for (; first != last; ++first) {
+      auto *new_node{create_node(*first)};
+      advance_path<false>(m_comparator, path, new_node->get());
+      link_node(new_node, path);
+    }
+  }
+
   template <class SeedSeq> void set_seed(SeedSeq &seed) {
     m_generator.seed(seed);
   }
 
+  // Moves every node of `other` into this list without allocating, equivalent
+  // elements of `other` go after the ones of this list. Nodes are spliced in
+  // one linear pass, or inserted one by one from the previous insertion
+  // point when `other` is small. An empty list takes the nodes of `other`
+  // in O(MaxNodeSize). Values are moved instead when the allocators differ.
   void merge(skip_list &other) {
-    if (this == &other) {
+    if (this == &other || other.empty()) {
       return;
     }
-    auto it{other.m_head};
-    while (it != nullptr) {
-      push(std::move(it->get()));
-      it = it->get_next(0U);
-    }
-    other.clear_elements();
+    if (!can_adopt_nodes(other)) {
+      auto it{other.first_node()};
+      while (it != nullptr) {
+        push(std::move(it->get()));
+        it = it->get_next(0U);
+      }
+      other.clear_elements();
+      return;
+    }
+    m_pool.adopt(other.m_pool);
+    if (empty()) {
+      swap_headers(other);
+      m_tail = std::exchange(other.m_tail, nullptr);
+      m_size = std::exchange(other.m_size, 0U);
+      return;
+    }
+    auto *first{other.first_node()};
+    other.reset_header();
+    other.m_tail = nullptr;
+    const auto count{std::exchange(other.m_size, 0U)};
+    // A finger insertion costs about log2(size()) hops, a splice visits
+    // every node once.
+    if (count * static_cast<size_type>(std::bit_width(m_size)) <
+        count + m_size) {
+      merge_by_insertion(first);
+    } else {
+      merge_by_splice(first);
+    }
   }
 
   void merge(skip_list &&other) {
@@ -388,210 +1256,1388 @@ public:
     merge(movedList);
   }
 
-  const_iterator find(const T &key) const noexcept {
-    if (value_out_of_range(key)) {
-      return cend();
+  // Moves the elements that do not go before `key` into a new list, cutting
+  // each level of the path to `key`. Indexed lists know the size of the cut
+  // and take O(MaxNodeSize + log n). Plain lists count the shorter side, an
+  // extra O(min(k, n - k)) that touches no value. A recycling node pool
+  // cannot be split, so the moved values get new nodes, and a move that
+  // throws leaves every element in this list.
+  skip_list split(const T &key) {
+    skip_list suffix(m_comparator, get_allocator());
+    suffix.m_generator = m_generator;
+    suffix.m_level_generator = m_level_generator;
+    search_path path{};
+    advance_path<false>(m_comparator, path, key);
+    auto *first{path.preds[0U]->get_next(0U)};
+    if (first == nullptr) {
+      return suffix;
     }
-    if (m_head != nullptr && m_head->get() == key) {
-      return cbegin();
+    size_type count{0U};
+    if constexpr (Indexed) {
+      count = m_size - rank_after(path);
+    } else {
+      count = count_from(first);
     }
-    for (auto it{m_head}; it != nullptr;) {
-      auto rbegin{it->rbegin()};
-      const auto rend{it->rend()};
-      for (; rbegin != rend; ++rbegin) {
-        if (*rbegin == nullptr) {
-          continue;
+    for (size_type level{0U}; level < path.known; ++level) {
+      if constexpr (Indexed) {
+        path.preds[level]->get_width(level) =
+            rank_after(path) + 1U - path.ranks[level];
+      }
+      path.preds[level]->get_next(level) = nullptr;
+    }
+    auto *last{m_tail};
+    m_tail = element_or_null(path.preds[0U]);
+    m_size -= count;
+    trim_levels();
+    if constexpr (Bidirectional) {
+      first->get_prev() = nullptr;
+    }
+    if constexpr (node_pool_type::recycles) {
+      suffix.append_moved(*this, first, last, count);
+    } else {
+      suffix.link_header(first);
+      suffix.m_tail = last;
+      suffix.m_size = count;
+    }
+    return suffix;
+  }
+
+  // Appends every element of `other`, none of which may go before the last
+  // element of this list, in O(MaxNodeSize + log n): the last link of each
+  // level i is pointed to the first node in `other` whose tower reaches level
+  // i. Values are moved instead when the allocators differ.
+  void join(skip_list &other) {
+    if (this == &other || other.empty()) {
+      return;
+    }
+    assert(empty() || !m_comparator(other.front(), back()));
+    // The last node of every level, the header on levels this list leaves
+    // empty.
+    auto path{header_path()};
+    if (m_tail != nullptr) {
+      find_preds<true>(m_header, m_tail->get(), path);
+    }
+    if (!can_adopt_nodes(other)) {
+      auto tails{path.preds};
+      auto *it{other.first_node()};
+      try {
+        for (; it != nullptr; it = it->get_next(0U)) {
+          append_node(tails, create_node(std::move(it->get())));
         }
-        const auto &value{(*rbegin)->get()};
-        if (value == key) {
-          return const_iterator{*rbegin};
-        } else if (m_comparator(value, key)) {
-          it = *rbegin;
-          break;
+      } catch (...) {
+        // The values already moved belong to this list now, their nodes are
+        // popped from `other` without comparing what is left in them.
+        while (other.first_node() != it) {
+          other.pop_front();
         }
+        throw;
       }
-      if (it != nullptr && rbegin == it->rend()) {
-        break;
+      other.clear_elements();
+      return;
+    }
+    m_pool.adopt(other.m_pool);
+    // The header of `other` holds the first tower of every level.
+    for (size_type level{0U}; level < MaxNodeSize; ++level) {
+      if constexpr (Indexed) {
+        path.preds[level]->get_width(level) +=
+            other.m_header->get_width(level) - 1U;
       }
+      path.preds[level]->get_next(level) = other.m_header->get_next(level);
     }
-    return cend();
+    if constexpr (Bidirectional) {
+      other.first_node()->get_prev() = m_tail;
+    }
+    m_tail = other.m_tail;
+    m_size += other.m_size;
+    m_levels = std::max(m_levels, other.m_levels);
+    other.reset_header();
+    other.m_tail = nullptr;
+    other.m_size = 0U;
   }
 
-  void pop_back() { erase(m_tail->get()); }
+  void join(skip_list &&other) {
+    auto movedList = std::move(other);
+    join(movedList);
+  }
 
-  void pop_front() { erase(m_head->get()); }
+  const_iterator find(const T &key) const noexcept { return find_impl(key); }
 
-  std::optional<T> extract(const T &key) {
-    auto node_ptr{erase_node(key)};
-    if (node_ptr) {
-      return std::move(node_ptr->get());
+  // Lookup, erase and bounds by any key the comparator compares with `T`
+  // when it is transparent, so no `T` is built for the search.
+  template <typename K>
+    requires detail::transparent_comparator<Compare>
+  const_iterator find(const K &key) const {
+    return find_impl(key);
+  }
+
+  // Bytes of nodes below which a list mostly stays in cache. Measured with
+  // 16-level int lists, whose two-level towers take 24 bytes: plain lookups
+  // win up to about 32k elements and lose by 2x at 256k.
+  static constexpr std::size_t batch_min_bytes{std::size_t{3U} << 19U};
+
+  // Smallest list `find_batch` interleaves, counted in two-level towers, the
+  // average height of the default level generator.
+  static constexpr size_type batch_min_size{std::max<size_type>(
+      batch_min_bytes / (node_type::storage_size(2U) *
+                         sizeof(typename node_type::storage_type)),
+      1U)};
+
+  // Writes to `out[i]` an iterator to an element equal to `keys[i]`, or
+  // `end()`, for keys in any order. `InFlight` searches run interleaved: each
+  // one prefetches the node it compares next and yields to the others, so
+  // their cache misses overlap instead of stalling one after another. A list
+  // of fewer than `batch_min_size` elements mostly fits in cache, where the
+  // bookkeeping made plain lookups two to three times faster, so it is
+  // searched key by key.
+  template <std::size_t InFlight = 16U>
+  void find_batch(std::span<const T> keys,
+                  std::span<const_iterator> out) const {
+    static_assert(InFlight > 0U);
+    assert(out.size() >= keys.size());
+    if (m_size < batch_min_size) {
+      std::transform(keys.begin(), keys.end(), out.begin(),
+                     [this](const T &key) { return find(key); });
+      return;
     }
-    return {};
+    std::array<batch_lookup, InFlight> lookups{};
+    std::size_t next_key{0U};
+    size_type active{0U};
+    const auto start{[&](batch_lookup &lookup) {
+      lookup = batch_lookup{next_key++, m_header,
+                            m_header->get_next(m_levels - 1U), m_levels};
+      detail::prefetch(lookup.candidate);
+    }};
+    while (active < InFlight && next_key < keys.size()) {
+      start(lookups[active++]);
+    }
+    while (active > 0U) {
+      for (size_type i{0U}; i < active;) {
+        auto &lookup{lookups[i]};
+        if (step_lookup(lookup, keys[lookup.key], out[lookup.key])) {
+          ++i;
+        } else if (next_key < keys.size()) {
+          start(lookup);
+          ++i;
+        } else {
+          lookup = lookups[--active];
+        }
+      }
+    }
+  }
+
+  // Writes to `out` an iterator to an element equal to every key of
+  // `[first, last)`, or `end()`. Searches share their path as in
+  // `insert_sorted`, so keys should be sorted.
+  template <typename InputIt, typename OutputIt>
+  OutputIt find_many(InputIt first, InputIt last, OutputIt out) const {
+    search_path path{};
+    for (; first != last; ++first, ++out) {
+      const auto &key{*first};
+      advance_path<false>(m_comparator, path, key);
+      const auto *candidate{path.preds[0U]->get_next(0U)};
+      *out = candidate != nullptr && !m_comparator(key, candidate->get())
+                 ? make_iterator(candidate)
+                 : cend();
+    }
+    return out;
+  }
+
+  // The tail is unlinked without comparing values, from predecessors found
+  // in expected O(MaxNodeSize) hops on bidirectional lists and O(log n)
+  // otherwise.
+  void pop_back() {
+    assert(m_tail != nullptr);
+    unlink_node(m_tail, tail_path());
+  }
+
+  // The first node follows the header on every level, it is unlinked in
+  // O(MaxNodeSize).
+  void pop_front() {
+    assert(first_node() != nullptr);
+    unlink_node(first_node(), header_path());
+  }
+
+  // As `pop_front` and `pop_back`, the value is moved out of its node.
+  std::optional<T> extract_front() {
+    if (empty()) {
+      return {};
+    }
+    node_holder node_ptr(detach_node(first_node(), header_path()),
+                         node_deleter{this});
+    return std::move(node_ptr->get());
+  }
+
+  std::optional<T> extract_back() {
+    if (empty()) {
+      return {};
+    }
+    node_holder node_ptr(detach_node(m_tail, tail_path()), node_deleter{this});
+    return std::move(node_ptr->get());
+  }
+
+  std::optional<T> extract(const T &key) { return extract_impl(key); }
+
+  template <typename K>
+    requires detail::transparent_comparator<Compare> &&
+             (!std::convertible_to<const K &, const_iterator>)
+  std::optional<T> extract(const K &key) {
+    return extract_impl(key);
   }
 
+  // Extracts the element at `position` itself, not one equivalent to it.
   std::optional<T> extract(const_iterator position) {
-    if (position != end()) {
-      return extract(*position);
+    if (position == end()) {
+      return {};
     }
-    return {};
+    auto *found{to_node(position)};
+    node_holder node_ptr(detach_node(found, path_to(found)),
+                         node_deleter{this});
+    return std::move(node_ptr->get());
   }
 
-  const_iterator erase(const T &key) {
-    auto node_ptr{erase_node(key)};
-    return node_ptr ? const_iterator{node_ptr->get_next(0)}
-                    : const_iterator{cend()};
+  // Unlinks the first element equivalent to `key` and hands its node over,
+  // an empty handle if there is none. Nodes of a recycling node pool belong
+  // to its slabs and cannot be handed over.
+  node_handle extract_node(const T &key)
+    requires(!node_pool_type::recycles)
+  {
+    return node_handle(erase_node(key).release(), m_allocator);
+  }
+
+  node_handle extract_node(const_iterator position)
+    requires(!node_pool_type::recycles)
+  {
+    if (position == end()) {
+      return {};
+    }
+    auto *found{to_node(position)};
+    return node_handle(detach_node(found, path_to(found)), m_allocator);
+  }
+
+  // Links the handle's node after the elements equivalent to its value, or
+  // returns `end()` for an empty handle.
+  iterator insert(node_handle &&handle) {
+    return insert(end(), std::move(handle));
+  }
+
+  // Searches forward from `hint` as the hinted value `insert` does.
+  iterator insert(const_iterator hint, node_handle &&handle) {
+    if (handle.empty()) {
+      return end();
+    }
+    assert(*handle.m_allocator == m_allocator);
+    auto *new_node{handle.release()};
+    new_node->clear_nexts();
+    auto *finger{hint == end() ? m_tail : to_node(hint)};
+    return insert_node_from<false>(finger, new_node, nullptr);
+  }
+
+  const_iterator erase(const T &key) { return erase_impl(key); }
+
+  // Erases the element at `position` itself and returns the one after it.
+  // Bidirectional lists find its predecessors by walking back, in expected
+  // O(MaxNodeSize) hops and no comparison.
+  const_iterator erase(const_iterator position) {
+    assert(position != end());
+    auto *found{to_node(position)};
+    const auto next{make_iterator(found->get_next(0U))};
+    unlink_node(found, path_to(found));
+    return next;
+  }
+
+  // Erases [first, last) and returns `last`. The predecessors of `first` are
+  // searched once, then every link of the run is cut while walking it, in
+  // O(log n + k) for k erased elements.
+  const_iterator erase(const_iterator first, const_iterator last) {
+    if (first == last) {
+      return last;
+    }
+    auto *node{to_node(first)};
+    auto *stop{last == end() ? nullptr : to_node(last)};
+    auto path{search_path_to(node)};
+    size_type count{0U};
+    while (node != stop) {
+      assert(node != nullptr);
+      auto *next{node->get_next(0U)};
+      const auto linked{std::min(path.known, node->capacity())};
+      for (size_type level{0U}; level < linked; ++level) {
+        if constexpr (Indexed) {
+          path.preds[level]->get_width(level) += node->get_width(level);
+        }
+        path.preds[level]->get_next(level) = node->get_next(level);
+      }
+      delete_node(node);
+      node = next;
+      ++count;
+    }
+    if constexpr (Indexed) {
+      for (size_type level{0U}; level < path.known; ++level) {
+        path.preds[level]->get_width(level) -= count;
+      }
+    }
+    auto *pred{element_or_null(path.preds[0U])};
+    if (stop == nullptr) {
+      m_tail = pred;
+    } else if constexpr (Bidirectional) {
+      stop->get_prev() = pred;
+    }
+    m_size -= count;
+    trim_levels();
+    return last;
+  }
+
+  template <typename K>
+    requires detail::transparent_comparator<Compare> &&
+             (!std::convertible_to<const K &, const_iterator>)
+  const_iterator erase(const K &key) {
+    return erase_impl(key);
+  }
+
+  // Erases one element equal to every key of `[first, last)` and returns the
+  // number of erased elements. Searches share their path as in
+  // `insert_sorted`, so keys should be sorted.
+  template <typename InputIt>
+  size_type erase_many(InputIt first, InputIt last) {
+    search_path path{};
+    size_type erased{0U};
+    for (; first != last; ++first) {
+      const auto &key{*first};
+      advance_path<false>(m_comparator, path, key);
+      auto *candidate{path.preds[0U]->get_next(0U)};
+      if (candidate != nullptr && !m_comparator(key, candidate->get())) {
+        unlink_node(candidate, path);
+        ++erased;
+      }
+    }
+    return erased;
+  }
+
+  // Positions, on indexed lists only. Every call is O(log n).
+
+  // Element at position `index`, or `end()` past the last one.
+  const_iterator nth(size_type index) const noexcept
+    requires Indexed
+  {
+    return index < m_size ? make_iterator(skip_forward(m_header, index + 1U))
+                          : cend();
+  }
+
+  const T &operator[](size_type index) const noexcept
+    requires Indexed
+  {
+    assert(index < m_size);
+    return skip_forward(m_header, index + 1U)->get();
+  }
+
+  // Number of elements that go before `key`, the position of
+  // `lower_bound(key)`.
+  size_type rank(const T &key) const
+    requires Indexed
+  {
+    search_path path{};
+    advance_path<false>(m_comparator, path, key);
+    return rank_after(path);
+  }
+
+  // Position of `position`, `size()` for `end()`. Elements equivalent to
+  // `*position` before it are walked.
+  size_type index_of(const_iterator position) const
+    requires Indexed
+  {
+    if (position == cend()) {
+      return m_size;
+    }
+    search_path path{};
+    advance_path<false>(m_comparator, path, *position);
+    auto index{rank_after(path)};
+    const node_type *it{path.preds[0U]->get_next(0U)};
+    for (; it != position.m_it; it = it->get_next(0U)) {
+      ++index;
+    }
+    return index;
+  }
+
+  difference_type distance(const_iterator first, const_iterator last) const
+    requires Indexed
+  {
+    return static_cast<difference_type>(index_of(last)) -
+           static_cast<difference_type>(index_of(first));
+  }
+
+  // Uniformly drawn element, `end()` when the list is empty.
+  template <typename Generator>
+  const_iterator sample(Generator &generator) const
+    requires Indexed
+  {
+    if (empty()) {
+      return cend();
+    }
+    std::uniform_int_distribution<size_type> index(0U, m_size - 1U);
+    return nth(index(generator));
   }
 
   const_iterator lower_bound(const T &key) const {
-    return bound_impl<std::greater_equal<T>>(key);
+    return bound_impl<false>(key);
+  }
+
+  template <typename K>
+    requires detail::transparent_comparator<Compare>
+  const_iterator lower_bound(const K &key) const {
+    return bound_impl<false>(key);
   }
 
   const_iterator upper_bound(const T &key) const {
-    return bound_impl<std::greater<T>>(key);
+    return bound_impl<true>(key);
+  }
+
+  template <typename K>
+    requires detail::transparent_comparator<Compare>
+  const_iterator upper_bound(const K &key) const {
+    return bound_impl<true>(key);
+  }
+
+  // Elements equivalent to `key`. The upper bound resumes from the path of
+  // the lower one, so a run of k elements costs O(log n + log k).
+  std::pair<const_iterator, const_iterator> equal_range(const T &key) const {
+    return equal_range_impl(key);
+  }
+
+  template <typename K>
+    requires detail::transparent_comparator<Compare>
+  std::pair<const_iterator, const_iterator> equal_range(const K &key) const {
+    return equal_range_impl(key);
+  }
+
+  // Number of elements equivalent to `key`, in O(log n) on indexed lists and
+  // O(log n + k) otherwise.
+  size_type count(const T &key) const { return count_impl(key); }
+
+  template <typename K>
+    requires detail::transparent_comparator<Compare>
+  size_type count(const K &key) const {
+    return count_impl(key);
+  }
+
+  bool contains(const T &key) const { return find_impl(key) != cend(); }
+
+  template <typename K>
+    requires detail::transparent_comparator<Compare>
+  bool contains(const K &key) const {
+    return find_impl(key) != cend();
   }
 
 private:
-  template <typename U> node_type *create_node(U &&value) {
-    allocator_rebind allocator;
-    node_type *result = allocator.allocate(1);
-    allocator_traits::construct(allocator, result,
-                                node_type(std::forward<U>(value), m_generator));
-    return result;
+  template <typename, typename, typename, int, std::size_t, typename,
+            typename>
+  friend class skip_map;
+
+  // Builds an element from `args` only when none is equivalent to `key`, the
+  // key the new element will have. One descent finds either the equivalent
+  // element or the position of the new one.
+  template <typename K, typename... Args>
+  std::pair<iterator, bool> emplace_unique(const K &key, Args &&...args) {
+    search_path path{};
+    if (auto *found{find_unique(key, path)}) {
+      return {make_iterator(found), false};
+    }
+    return {emplace_at(path, std::forward<Args>(args)...), true};
   }
 
-  void delete_node(node_type *&node_ptr) noexcept {
-    allocator_rebind allocator;
-    allocator_traits::destroy(allocator, node_ptr);
-    allocator_traits::deallocate(allocator, node_ptr, 1);
-    node_ptr = nullptr;
+  // The element equivalent to `key`, or null when there is none and `path`
+  // leads to the position of a new element with that key.
+  template <typename K> node_type *find_unique(const K &key, search_path &path) {
+    advance_path<false>(m_comparator, path, key);
+    auto *next{path.preds[0U]->get_next(0U)};
+    return next != nullptr && !m_comparator(key, next->get()) ? next : nullptr;
+  }
+
+  template <typename... Args>
+  iterator emplace_at(const search_path &path, Args &&...args) {
+    auto *new_node{create_node(std::forward<Args>(args)...)};
+    link_node(new_node, path);
+    return make_iterator(new_node);
+  }
+
+  // Inserts before the elements equivalent to `new_node`. One descent
+  // records the predecessor of every level, then only the links of those
+  // predecessors and of the new tower are written.
+  iterator insert_node(node_type *new_node, size_type *visited_nodes_counter) {
+    if (visited_nodes_counter) {
+      *visited_nodes_counter = 0U;
+    }
+    search_path path{};
+    find_preds<false>(m_header, new_node->get(), path, visited_nodes_counter);
+    link_node(new_node, path);
+    return make_iterator(new_node);
+  }
+
+  // The descent compares each node once and stops before the first element
+  // that does not go before `key`, which holds the key if anything does.
+  template <typename K> const_iterator find_impl(const K &key) const {
+    const auto candidate{bound_impl<false>(key)};
+    return candidate != cend() && !m_comparator(key, *candidate) ? candidate
+                                                                 : cend();
   }
 
-  std::unique_ptr<node_type> erase_node(const T &key) {
-    if (empty() || value_out_of_range(key)) {
-      return nullptr;
+  bool can_adopt_nodes(const skip_list &other) const noexcept {
+    if constexpr (allocator_traits::is_always_equal::value) {
+      return true;
+    } else {
+      return m_allocator == other.m_allocator;
     }
-    if (m_head != nullptr && m_head->get() == key) {
-      if (m_head == m_tail) {
-        m_tail = nullptr;
+  }
+
+  // First node after `start`, which goes before `key`, that does not go
+  // before `key`. Found by climbing to taller towers and descending, in
+  // O(log d) for a distance d.
+  template <typename Comparator>
+  static const node_type *seek(Comparator &comparator, const node_type *start,
+                               const T &key) {
+    const auto *current{start};
+    size_type level{current->capacity()};
+    const node_type *stop{nullptr};
+    while (level > 0U) {
+      const auto *next{current->get_next(level - 1U)};
+      if (next != nullptr && next != stop && comparator(next->get(), key)) {
+        current = next;
+        level = current->capacity();
+      } else {
+        stop = next;
+        --level;
       }
-      --m_size;
-      auto next{m_head->get_next(0U)};
-      auto old_head{m_head};
-      m_head = next;
-      return std::unique_ptr<node_type>(old_head);
     }
+    return current->get_next(0U);
+  }
 
-    std::array<node_type *, MaxNodeSize> observers{nullptr};
-    auto obs{observers.begin()};
-    node_type *found{nullptr};
-    for (auto it{m_head}; it != nullptr;) {
-      auto rbegin{it->rbegin()};
-      const auto rend{it->rend()};
-      for (; rbegin != rend; ++rbegin) {
-        if (*rbegin == nullptr) {
-          continue;
+  // Walks both lists in order and appends to the result the elements only
+  // in `lhs`, only in `rhs` and in both, as selected. A matched pair takes
+  // one element from each side, so a value held m and n times is in both
+  // min(m, n) times. Elements come out sorted, so each one is appended to
+  // the level tails without a search.
+  template <bool OnlyLhs, bool OnlyRhs, bool Both>
+  static skip_list combine(const skip_list &lhs, const skip_list &rhs) {
+    skip_list result(lhs.m_comparator, lhs.get_allocator());
+    result.m_generator = lhs.m_generator;
+    result.m_level_generator = lhs.m_level_generator;
+    auto &comparator{result.m_comparator};
+    auto tails{result.header_tails()};
+    const auto append{[&](const node_type *first, const node_type *last) {
+      for (; first != last; first = first->get_next(0U)) {
+        result.append_node(tails, result.create_node(first->get()));
+      }
+    }};
+    const auto *left{lhs.first_node()};
+    const auto *right{rhs.first_node()};
+    while (left != nullptr && right != nullptr) {
+      if (comparator(left->get(), right->get())) {
+        const auto *run_end{seek(comparator, left, right->get())};
+        if constexpr (OnlyLhs) {
+          append(left, run_end);
+        }
+        left = run_end;
+      } else if (comparator(right->get(), left->get())) {
+        const auto *run_end{seek(comparator, right, left->get())};
+        if constexpr (OnlyRhs) {
+          append(right, run_end);
         }
-        const auto &value{(*rbegin)->get()};
-        if (value == key) {
-          *(obs++) = it;
-          found = *rbegin;
-        } else if (m_comparator(value, key)) {
-          it = *rbegin;
-          break;
+        right = run_end;
+      } else {
+        if constexpr (Both) {
+          append(left, left->get_next(0U));
+        }
+        left = left->get_next(0U);
+        right = right->get_next(0U);
+      }
+    }
+    if constexpr (OnlyLhs) {
+      append(left, nullptr);
+    }
+    if constexpr (OnlyRhs) {
+      append(right, nullptr);
+    }
+    return result;
+  }
+
+  // Number of nodes from `first` on, walked from both ends of the list at
+  // once so only the shorter side is counted.
+  size_type count_from(const node_type *first) const noexcept {
+    const auto *prefix{first_node()};
+    const auto *suffix{first};
+    for (size_type count{0U};; ++count) {
+      if (prefix == first) {
+        return m_size - count;
+      }
+      if (suffix == nullptr) {
+        return count;
+      }
+      prefix = prefix->get_next(0U);
+      suffix = suffix->get_next(0U);
+    }
+  }
+
+  // Moves the values of the `count` nodes from `first` to `last`, cut from
+  // the end of `source`, into new nodes appended to this empty list and
+  // frees the old nodes. If a move throws, the new nodes and then the nodes
+  // not moved yet are joined back to `source`.
+  void append_moved(skip_list &source, node_type *first, node_type *last,
+                    size_type count) {
+    assert(empty());
+    auto tails{header_tails()};
+    try {
+      while (first != nullptr) {
+        append_node(tails, create_node(std::move(first->get())));
+        auto *next{first->get_next(0U)};
+        source.delete_node(first);
+        first = next;
+        --count;
+      }
+    } catch (...) {
+      source.join(*this);
+      // The rest of the cut keeps its links, it only needs a header.
+      link_header(first);
+      m_tail = last;
+      m_size = count;
+      source.join(*this);
+      throw;
+    }
+  }
+
+  // Relinks the nodes of both lists in sorted order with the last node of
+  // every level, the towers are kept as they are.
+  void merge_by_splice(node_type *other) noexcept {
+    auto *current{first_node()};
+    reset_header();
+    auto tails{header_tails()};
+    m_tail = nullptr;
+    m_size = 0U;
+    while (current != nullptr || other != nullptr) {
+      if (other == nullptr ||
+          (current != nullptr && !m_comparator(other->get(), current->get()))) {
+        append_node(tails, std::exchange(current, current->get_next(0U)));
+      } else {
+        append_node(tails, std::exchange(other, other->get_next(0U)));
+      }
+    }
+    for (size_type level{0U}; level < tails.size(); ++level) {
+      tails[level]->get_next(level) = nullptr;
+    }
+  }
+
+  // Inserts sorted nodes one by one, each search starts from the node
+  // inserted before.
+  void merge_by_insertion(node_type *other) {
+    node_type *finger{nullptr};
+    while (other != nullptr) {
+      auto *new_node{std::exchange(other, other->get_next(0U))};
+      new_node->clear_nexts();
+      insert_node_from<true>(finger, new_node, nullptr);
+      finger = new_node;
+    }
+  }
+
+  // Inserts `new_node` before the elements equivalent to it, or after them
+  // with `AfterEquivalent`. The search starts from `finger` if it goes before
+  // the new node, and from the header if the finger is wrong or cannot see
+  // every level of the new tower.
+  template <bool AfterEquivalent>
+  iterator insert_node_from(node_type *finger, node_type *new_node,
+                            size_type *visited_nodes_counter) {
+    search_path path{};
+    if (finger != nullptr &&
+        goes_before<AfterEquivalent>(m_comparator, finger->get(),
+                                     new_node->get())) {
+      find_preds<AfterEquivalent>(finger, new_node->get(), path,
+                                  visited_nodes_counter);
+    }
+    // Predecessors above the levels seen from the finger may lie before it,
+    // only those are searched from the header. Ranks of two searches cannot be
+    // compared, so indexed lists search every level again when the new tower
+    // is taller. Otherwise they still search the upper levels, whose links
+    // now span one more element.
+    if (path.known < new_node->capacity()) {
+      if constexpr (Indexed) {
+        path.known = 0U;
+      }
+      find_preds<AfterEquivalent>(m_header, new_node->get(), path,
+                                  visited_nodes_counter, path.known);
+    } else if constexpr (Indexed) {
+      find_preds<AfterEquivalent>(m_header, new_node->get(), path,
+                                  visited_nodes_counter, path.known);
+    }
+    link_node(new_node, path);
+    return make_iterator(new_node);
+  }
+
+  // Iterators of bidirectional lists know their list, so `end()` can step
+  // back to the tail.
+  const_iterator make_iterator(const node_type *node) const noexcept {
+    return const_iterator{node, this};
+  }
+
+  static node_type *to_node(const_iterator position) noexcept {
+    // The list is not const, so neither are its nodes.
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
+    return const_cast<node_type *>(position.m_it);
+  }
+
+  // Fills `path.preds[level]` with the last node of every level that goes
+  // before `key`, searching forward from `start` that must itself go before
+  // `key`, or be the header. Only the first `path.known` levels are filled,
+  // higher levels have their predecessor before `start`. With
+  // `AfterEquivalent` the position is after the elements equivalent to `key`.
+  // Levels below `lowest_level` are left untouched and `path.known` never
+  // decreases.
+  template <bool AfterEquivalent>
+  void find_preds(node_type *start, const T &key, search_path &path,
+                  size_type *visited_nodes_counter = nullptr,
+                  size_type lowest_level = 0U) {
+    auto *current{start};
+    size_type level{start != m_header ? start->capacity()
+                                      : enter_header(path, lowest_level)};
+    [[maybe_unused]] size_type rank{0U};
+    // The header holds no element.
+    size_type visited{start != m_header ? 1U : 0U};
+    path.known = std::max(path.known, level);
+    const node_type *stop{nullptr};
+    while (level > 0U) {
+      auto *next{current->get_next(level - 1U)};
+      if (next != nullptr && next != stop &&
+          goes_before<AfterEquivalent>(m_comparator, next->get(), key)) {
+        if constexpr (Indexed) {
+          rank += current->get_width(level - 1U);
         }
+        ++visited;
+        current = next;
+        level = current->capacity();
+        path.known = std::max(path.known, level);
+        continue;
       }
-      if (it != nullptr && rbegin == it->rend()) {
+      stop = next;
+      // Lower levels are still walked while they may lead to taller towers,
+      // nothing taller than `level` is left once it stops moving.
+      if (--level < lowest_level) {
         break;
       }
+      path.preds[level] = current;
+      if constexpr (Indexed) {
+        path.ranks[level] = rank;
+      }
     }
-    if (found == nullptr) {
-      return nullptr;
+    if (visited_nodes_counter) {
+      *visited_nodes_counter += visited;
     }
-    --m_size;
-    for (auto o : observers) {
-      if (o == nullptr) {
+  }
+
+  // Node `steps` positions after `start`, null one past the last node.
+  static const node_type *skip_forward(const node_type *start,
+                                       size_type steps) noexcept
+    requires Indexed
+  {
+    const auto *current{start};
+    while (steps > 0U) {
+      assert(current != nullptr);
+      auto level{current->capacity()};
+      while (current->get_width(level - 1U) > steps) {
+        --level;
+      }
+      steps -= current->get_width(level - 1U);
+      current = current->get_next(level - 1U);
+    }
+    return current;
+  }
+
+  // Position of the node after `path`. Ranks count from the header at 0, so
+  // a node's rank is one past its position.
+  static size_type rank_after(const search_path &path) noexcept
+    requires Indexed
+  {
+    return path.ranks[0U];
+  }
+
+  // One search of `find_batch`: `current` goes before the key and
+  // `candidate`, its next node on `level`, is the one compared next.
+  struct batch_lookup {
+    std::size_t key;
+    const node_type *current;
+    const node_type *candidate;
+    size_type level;
+  };
+
+  // Compares `lookup.candidate` and picks the next one, returns false once
+  // the result is written to `out`.
+  bool step_lookup(batch_lookup &lookup, const T &key,
+                   const_iterator &out) const {
+    if (lookup.candidate != nullptr &&
+        m_comparator(lookup.candidate->get(), key)) {
+      lookup.current = lookup.candidate;
+      lookup.level = lookup.current->capacity();
+      lookup.candidate = lookup.current->get_next(lookup.level - 1U);
+      detail::prefetch(lookup.candidate);
+      return true;
+    }
+    // Levels below that lead to the same candidate are not compared again.
+    const auto *failed{lookup.candidate};
+    do {
+      if (lookup.level == 1U) {
+        out = failed != nullptr && !m_comparator(key, failed->get())
+                  ? make_iterator(failed)
+                  : cend();
+        return false;
+      }
+      --lookup.level;
+      lookup.candidate = lookup.current->get_next(lookup.level - 1U);
+    } while (lookup.candidate == failed);
+    detail::prefetch(lookup.candidate);
+    return true;
+  }
+
+  // Moves `path` forward to `key`. Levels are climbed only while their
+  // predecessor changes, so a key at distance d from the previous one costs
+  // O(log d). A key that goes before the path restarts from the header.
+  template <bool AfterEquivalent, typename Comparator, typename K>
+  void advance_path(Comparator &comparator, search_path &path,
+                    const K &key) const {
+    const auto before{[&](const node_type *node) {
+      return node != nullptr &&
+             goes_before<AfterEquivalent>(comparator, node->get(), key);
+    }};
+    if (path.known > 0U && path.preds[0U] != m_header &&
+        !before(path.preds[0U])) {
+      path.known = 0U;
+    }
+    size_type level{0U};
+    while (level < path.known && before(path.preds[level]->get_next(level))) {
+      ++level;
+    }
+    // The search resumes from the predecessor of `level`, or the highest
+    // one when every known level moves on as taller towers may lie before
+    // `key`.
+    node_type *current{m_header};
+    [[maybe_unused]] size_type rank{0U};
+    if (path.known > 0U) {
+      const auto resumed{std::min(level, path.known - 1U)};
+      current = path.preds[resumed];
+      if constexpr (Indexed) {
+        rank = path.ranks[resumed];
+      }
+      if (level >= path.known) {
+        level = current != m_header ? current->capacity() : enter_header(path);
+      }
+    } else {
+      level = enter_header(path);
+    }
+    path.known = std::max(path.known, level);
+    // A node that does not go before `key` is often the next one on the
+    // levels below too, it is compared once.
+    const node_type *stop{nullptr};
+    while (level > 0U) {
+      auto *next{current->get_next(level - 1U)};
+      if (next != stop && before(next)) {
+        if constexpr (Indexed) {
+          rank += current->get_width(level - 1U);
+        }
+        current = next;
+        level = current->capacity();
+        path.known = std::max(path.known, level);
         continue;
       }
-      for (auto rit{o->rbegin()}; rit != o->rend(); ++rit) {
-        if (*rit == found) {
-          *rit = nullptr;
+      stop = next;
+      path.preds[--level] = current;
+      if constexpr (Indexed) {
+        path.ranks[level] = rank;
+      }
+    }
+  }
+
+  // Predecessors of `node` as `detach_node` needs them. A non-indexed
+  // bidirectional list walks back: on each level the predecessor is the
+  // nearest node before that is tall enough. Otherwise the value is searched
+  // and the equivalent elements before `node` are stepped over.
+  search_path path_to(node_type *node) {
+    search_path path{};
+    if constexpr (Bidirectional && !Indexed) {
+      const auto levels{node->capacity()};
+      for (auto *pred{node->get_prev()}; pred != nullptr && path.known < levels;
+           pred = pred->get_prev()) {
+        while (path.known < std::min(pred->capacity(), levels)) {
+          path.preds[path.known++] = pred;
+        }
+      }
+      // Levels that no node before reaches follow the header.
+      while (path.known < levels) {
+        path.preds[path.known++] = m_header;
+      }
+    } else {
+      path = search_path_to(node);
+    }
+    return path;
+  }
+
+  // Predecessors of `node` on every level, found by searching its value and
+  // stepping over the equivalent elements before it.
+  search_path search_path_to(node_type *node) {
+    search_path path{};
+    advance_path<false>(m_comparator, path, node->get());
+    auto *it{path.preds[0U]->get_next(0U)};
+    for (; it != node; it = it->get_next(0U)) {
+      assert(it != nullptr);
+      [[maybe_unused]] size_type rank{0U};
+      if constexpr (Indexed) {
+        rank = rank_after(path) + 1U;
+      }
+      for (size_type level{0U}; level < it->capacity(); ++level) {
+        path.preds[level] = it;
+        if constexpr (Indexed) {
+          path.ranks[level] = rank;
         }
       }
-      if (o->get_next(0) == nullptr) {
-        o->get_next(0) = found->get_next(0);
+      path.known = std::max(path.known, it->capacity());
+    }
+    return path;
+  }
+
+  // Predecessors of the tail. Non-indexed bidirectional lists walk back,
+  // other lists follow the links from the header until they reach the tail
+  // or the end of their level, which compares no value.
+  search_path tail_path() {
+    if constexpr (Bidirectional && !Indexed) {
+      return path_to(m_tail);
+    } else {
+      search_path path{};
+      auto *current{m_header};
+      size_type level{enter_header(path)};
+      while (level > 0U) {
+        auto *next{current->get_next(level - 1U)};
+        if (next != nullptr && next != m_tail) {
+          current = next;
+          level = current->capacity();
+          path.known = std::max(path.known, level);
+          continue;
+        }
+        path.preds[--level] = current;
       }
+      return path;
     }
-    if (found == m_tail) {
-      m_tail = *(obs - 1);
+  }
+
+  // Unlinks `node`, the first node after `path`, and returns it.
+  node_type *detach_node(node_type *node, const search_path &path) noexcept {
+    const auto linked{std::min(path.known, node->capacity())};
+    for (size_type level{0U}; level < linked; ++level) {
+      if constexpr (Indexed) {
+        path.preds[level]->get_width(level) += node->get_width(level) - 1U;
+      }
+      path.preds[level]->get_next(level) = node->get_next(level);
+    }
+    if constexpr (Indexed) {
+      for (auto level{linked}; level < path.known; ++level) {
+        --path.preds[level]->get_width(level);
+      }
     }
-    for (auto o : observers) {
-      if (o != nullptr) {
-        o->fill_nexts();
+    if constexpr (Bidirectional) {
+      if (auto *next{node->get_next(0U)}; next != nullptr) {
+        next->get_prev() = node->get_prev();
       }
     }
-    return std::unique_ptr<node_type>(found);
+    if (node == m_tail) {
+      m_tail = element_or_null(path.preds[0U]);
+    }
+    --m_size;
+    trim_levels();
+    return node;
+  }
+
+  void unlink_node(node_type *node, const search_path &path) noexcept {
+    auto *detached{detach_node(node, path)};
+    delete_node(detached);
   }
 
-  bool value_out_of_range(const T &value) const noexcept {
-    return m_tail != nullptr && (m_comparator(m_tail->get(), value) ||
-                                 m_comparator(value, m_head->get()));
+  template <bool AfterEquivalent, typename Comparator, typename K>
+  static bool goes_before(Comparator &comparator, const T &value,
+                          const K &key) {
+    if constexpr (AfterEquivalent) {
+      return !comparator(key, value);
+    } else {
+      return comparator(value, key);
+    }
+  }
+
+  // Links `new_node` after `path`, which holds its predecessor on the first
+  // `path.known` levels, at least as many as the new tower has. The header
+  // is the predecessor on every level no node reaches.
+  void link_node(node_type *new_node, const search_path &path) noexcept {
+    const auto known{path.known};
+    assert(known >= new_node->capacity());
+    const auto linked{new_node->capacity()};
+    for (size_type level{0U}; level < linked; ++level) {
+      auto *pred{path.preds[level]};
+      if constexpr (Indexed) {
+        const auto distance{rank_after(path) + 1U - path.ranks[level]};
+        new_node->get_width(level) = pred->get_width(level) - distance + 1U;
+        pred->get_width(level) = distance;
+      }
+      new_node->get_next(level) = pred->get_next(level);
+      pred->get_next(level) = new_node;
+    }
+    m_levels = std::max(m_levels, linked);
+    if constexpr (Indexed) {
+      for (auto level{linked}; level < known; ++level) {
+        ++path.preds[level]->get_width(level);
+      }
+    }
+    if constexpr (Bidirectional) {
+      new_node->get_prev() = element_or_null(path.preds[0U]);
+      if (auto *next{new_node->get_next(0U)}; next != nullptr) {
+        next->get_prev() = new_node;
+      }
+    }
+    if (new_node->get_next(0U) == nullptr) {
+      m_tail = new_node;
+    }
+    ++m_size;
+  }
+
+  // Builds an empty list from `[first, last)`. While the input is sorted
+  // every node is appended and linked on all its levels in one sweep, the
+  // first element out of order and everything after it are inserted.
+  template <typename InputIt> void build(InputIt first, InputIt last) {
+    assert(empty());
+    auto tails{header_tails()};
+    for (; first != last; ++first) {
+      auto *new_node{create_node(*first)};
+      if (m_tail != nullptr && m_comparator(new_node->get(), m_tail->get())) {
+        insert_node(new_node, nullptr);
+        ++first;
+        break;
+      }
+      append_node(tails, new_node);
+    }
+    for (; first != last; ++first) {
+      emplace(*first);
+    }
+  }
+
+  // Clones the nodes of `other` in order into this empty list, so no value
+  // is compared and every tower keeps its height.
+  void copy_elements(const skip_list &other) {
+    assert(empty());
+    auto tails{header_tails()};
+    for (const auto *it{other.first_node()}; it != nullptr;
+         it = it->get_next(0U)) {
+      append_node(tails, clone_node(*it));
+    }
+  }
+
+  // Every element is built in its node from `args`, without `args` it is
+  // value-initialized, so move-only values need no copy.
+  template <typename... Args>
+  void append_values(size_type count, const Args &...args) {
+    assert(empty());
+    auto tails{header_tails()};
+    while (count-- > 0U) {
+      append_node(tails, create_node(args...));
+    }
+  }
+
+  // `new_node` must not sort before `m_tail`, `tails` holds the last node of
+  // every level, or the header.
+  void append_node(level_tails &tails, node_type *new_node) noexcept {
+    for (size_type level{0U}; level < new_node->capacity(); ++level) {
+      tails[level]->get_next(level) = new_node;
+      tails[level] = new_node;
+      if constexpr (Indexed) {
+        new_node->get_width(level) = 1U;
+      }
+    }
+    m_levels = std::max(m_levels, new_node->capacity());
+    // Widths of the last links reach the end of the list.
+    if constexpr (Indexed) {
+      for (auto level{new_node->capacity()}; level < MaxNodeSize; ++level) {
+        ++tails[level]->get_width(level);
+      }
+    }
+    if constexpr (Bidirectional) {
+      new_node->get_prev() = m_tail;
+    }
+    m_tail = new_node;
+    ++m_size;
+  }
+
+  static size_type random_capacity(LevelGenerator &level_generator,
+                                   std::mt19937 &generator) {
+    const size_type capacity = level_generator(generator);
+    assert(capacity >= 1U && capacity <= MaxNodeSize);
+    return std::clamp<size_type>(capacity, 1U, MaxNodeSize);
+  }
+
+  size_type random_capacity() {
+    return random_capacity(m_level_generator, m_generator);
+  }
+
+  template <typename... Args> node_type *create_node(Args &&...args) {
+    const auto capacity{random_capacity()};
+    auto *storage{m_pool.allocate(m_allocator, capacity)};
+    try {
+      return node_type::construct(m_allocator, storage, capacity,
+                                  std::forward<Args>(args)...);
+    } catch (...) {
+      m_pool.deallocate(m_allocator, storage, capacity);
+      throw;
+    }
+  }
+
+  node_type *clone_node(const node_type &source) {
+    const auto capacity{source.capacity()};
+    auto *storage{m_pool.allocate(m_allocator, capacity)};
+    try {
+      return node_type::clone(m_allocator, storage, source);
+    } catch (...) {
+      m_pool.deallocate(m_allocator, storage, capacity);
+      throw;
+    }
+  }
+
+  void delete_node(node_type *&node_ptr) noexcept {
+    const auto capacity{node_ptr->capacity()};
+    m_pool.deallocate(m_allocator, node_type::destruct(m_allocator, node_ptr),
+                      capacity);
+    node_ptr = nullptr;
+  }
+
+  // Nodes live in the pool they were allocated from, so the pool moves with
+  // them. The pool of `this` must be empty.
+  void steal_elements(skip_list &other) noexcept {
+    swap_headers(other);
+    m_tail = std::exchange(other.m_tail, nullptr);
+    m_size = std::exchange(other.m_size, 0U);
+    m_pool.swap(other.m_pool);
+  }
+
+  // Used when the allocators differ and nodes cannot change owner.
+  void move_elements(skip_list &other) {
+    for (auto it{other.first_node()}; it != nullptr; it = it->get_next(0U)) {
+      emplace(std::move(it->get()));
+    }
+    other.clear_elements();
+  }
+
+  template <typename K> std::optional<T> extract_impl(const K &key) {
+    auto node_ptr{erase_node(key)};
+    if (node_ptr) {
+      return std::move(node_ptr->get());
+    }
+    return {};
+  }
+
+  template <typename K> const_iterator erase_impl(const K &key) {
+    auto node_ptr{erase_node(key)};
+    return node_ptr ? make_iterator(node_ptr->get_next(0)) : cend();
+  }
+
+  template <typename K>
+  std::pair<const_iterator, const_iterator>
+  equal_range_impl(const K &key) const {
+    search_path path{};
+    advance_path<false>(m_comparator, path, key);
+    const auto first{path_end(path)};
+    if (first == cend() || m_comparator(key, *first)) {
+      return {first, first};
+    }
+    advance_path<true>(m_comparator, path, key);
+    return {first, path_end(path)};
+  }
+
+  template <typename K> size_type count_impl(const K &key) const {
+    if constexpr (Indexed) {
+      search_path path{};
+      advance_path<false>(m_comparator, path, key);
+      const auto first{rank_after(path)};
+      advance_path<true>(m_comparator, path, key);
+      return rank_after(path) - first;
+    } else {
+      const auto [first, last] = equal_range_impl(key);
+      return static_cast<size_type>(std::distance(first, last));
+    }
+  }
+
+  // Unlinks the first element equivalent to `key`, found as in `find`.
+  template <typename K> node_holder erase_node(const K &key) {
+    search_path path{};
+    advance_path<false>(m_comparator, path, key);
+    auto *found{path.preds[0U]->get_next(0U)};
+    if (found == nullptr || m_comparator(key, found->get())) {
+      return node_holder(nullptr, node_deleter{this});
+    }
+    return node_holder(detach_node(found, path), node_deleter{this});
   }
 
   void clear_elements() noexcept {
-    m_size = 0U;
-    if (m_head == nullptr) {
+    auto *current{first_node()};
+    if (current == nullptr) {
       return;
     }
-    if (m_head == m_tail) {
-      delete_node(m_head);
-      m_tail = nullptr;
+    reset_header();
+    m_tail = nullptr;
+    m_size = 0U;
+    // Trivial values need no destructor call, so the whole pool is recycled
+    // without visiting the nodes.
+    if constexpr (node_pool_type::recycles &&
+                  std::is_trivially_destructible_v<T>) {
+      m_pool.reset();
       return;
     }
-    while (m_head != m_tail) {
-      auto next{m_head->get_next(0U)};
-      delete_node(m_head);
-      m_head = next;
+    while (current != nullptr) {
+      auto *next{current->get_next(0U)};
+      delete_node(current);
+      current = next;
     }
-    delete_node(m_tail);
-    m_head = nullptr;
   }
 
-  template <typename Comparator> const_iterator bound_impl(const T &key) const {
-    if (empty()) {
-      return {};
+  static node_type *make_header(header_storage &storage) noexcept {
+    auto *header{node_type::construct_header(storage.data())};
+    if constexpr (Indexed) {
+      for (size_type level{0U}; level < MaxNodeSize; ++level) {
+        header->get_width(level) = 1U;
+      }
     }
-    Comparator cmp{};
-    auto it{m_head};
-    while (it != nullptr) {
-      if (cmp(it->get(), key)) {
-        return const_iterator{it};
-      }
-      size_type last_gt{1U};
-      for (; last_gt < it->capacity(); ++last_gt) {
-        const auto next = it->get_next(last_gt);
-        if (!next || cmp(next->get(), key)) {
-          break;
+    return header;
+  }
+
+  // Unlinks every level of the header, as in an empty list.
+  void reset_header() noexcept {
+    m_header->clear_nexts();
+    m_levels = 0U;
+    if constexpr (Indexed) {
+      for (size_type level{0U}; level < MaxNodeSize; ++level) {
+        m_header->get_width(level) = 1U;
+      }
+    }
+  }
+
+  void swap_headers(skip_list &other) noexcept {
+    for (size_type level{0U}; level < MaxNodeSize; ++level) {
+      std::swap(m_header->get_next(level), other.m_header->get_next(level));
+      if constexpr (Indexed) {
+        std::swap(m_header->get_width(level),
+                  other.m_header->get_width(level));
+      }
+    }
+    std::swap(m_levels, other.m_levels);
+  }
+
+  // Points every level of the header of this empty list to the first tower
+  // tall enough of the nodes from `first` on, found by climbing them.
+  void link_header(node_type *first) noexcept {
+    auto *target{first};
+    [[maybe_unused]] size_type rank{1U};
+    for (size_type level{0U}; level < MaxNodeSize; ++level) {
+      while (target != nullptr && target->capacity() <= level) {
+        if constexpr (Indexed) {
+          rank += target->get_width(target->capacity() - 1U);
         }
+        target = target->get_next(target->capacity() - 1U);
+      }
+      if (target != nullptr) {
+        m_levels = level + 1U;
+      }
+      m_header->get_next(level) = target;
+      if constexpr (Indexed) {
+        // Past the last node the climb has counted every node.
+        m_header->get_width(level) = rank;
       }
-      it = it->get_next(last_gt - 1U);
     }
-    return {};
   }
 
-  node_type *m_head{nullptr};
+  // Predecessors of the first node, the header on every level.
+  search_path header_path() const noexcept {
+    search_path path{};
+    path.preds.fill(m_header);
+    path.known = MaxNodeSize;
+    return path;
+  }
+
+  // Starts a search from the header: above `m_levels` it links no node, so
+  // those levels are filled without a look and the search begins on the
+  // level it returns. Levels below `lowest_level` are left untouched.
+  size_type enter_header(search_path &path,
+                         size_type lowest_level = 0U) const noexcept {
+    for (auto level{std::max(m_levels, lowest_level)}; level < MaxNodeSize;
+         ++level) {
+      path.preds[level] = m_header;
+      if constexpr (Indexed) {
+        path.ranks[level] = 0U;
+      }
+    }
+    path.known = MaxNodeSize;
+    return m_levels;
+  }
+
+  // Lowers `m_levels` past the header levels that no longer link a node.
+  void trim_levels() noexcept {
+    while (m_levels > 0U && m_header->get_next(m_levels - 1U) == nullptr) {
+      --m_levels;
+    }
+  }
+
+  level_tails header_tails() const noexcept {
+    level_tails tails{};
+    tails.fill(m_header);
+    return tails;
+  }
+
+  node_type *first_node() const noexcept { return m_header->get_next(0U); }
+
+  // Paths hold the header where no node precedes, which is no element.
+  node_type *element_or_null(node_type *node) const noexcept {
+    return node != m_header ? node : nullptr;
+  }
+
+  // First element that does not go before `key`, or after it with
+  // `AfterEquivalent`.
+  template <bool AfterEquivalent, typename K>
+  const_iterator bound_impl(const K &key) const {
+    search_path path{};
+    advance_path<AfterEquivalent>(m_comparator, path, key);
+    return path_end(path);
+  }
+
+  // Element after `path`.
+  const_iterator path_end(const search_path &path) const noexcept {
+    return make_iterator(path.preds[0U]->get_next(0U));
+  }
+
+  // The header is a full height tower without value in front of the first
+  // node. Every level has a predecessor, so searches and links need no case
+  // for the first node or an empty list. It lives in the list itself, never
+  // in the pool, and is not moved with the nodes.
+  header_storage m_header_storage{};
+  node_type *m_header{make_header(m_header_storage)};
+  // Levels of the header that may link a node, at least as many as the
+  // tallest tower has. Searches from the header start on the highest of
+  // them instead of stepping down the empty levels above.
+  size_type m_levels{0U};
   node_type *m_tail{nullptr};
   size_type m_size{0U};
-  Allocator m_allocator;
-  Compare m_comparator;
+  [[no_unique_address]] allocator_rebind m_allocator;
+  [[no_unique_address]] Compare m_comparator;
   std::mt19937 m_generator{std::random_device{}()};
+  [[no_unique_address]] LevelGenerator m_level_generator;
+  [[no_unique_address]] node_pool_type m_pool;
 
   template <typename IteratorValueType> class iterator_impl {
   public:
     using difference_type = ptrdiff_t;
     using value_type = T;
     iterator_impl() noexcept = default;
-    explicit iterator_impl(IteratorValueType *val_ptr) noexcept
-        : m_it(val_ptr) {}
+    explicit iterator_impl(IteratorValueType *val_ptr,
+                           const skip_list *list) noexcept
+        : m_it(val_ptr) {
+      if constexpr (Bidirectional) {
+        m_list = list;
+      } else {
+        static_cast<void>(list);
+      }
+    }
 
     const value_type &operator*() const noexcept {
       assert(m_it != nullptr);
@@ -620,32 +2666,457 @@ private:
 
     bool operator==(std::nullptr_t) const { return m_it == nullptr; }
 
+    // Steps back through the level 0 back links, `end()` steps to the tail.
+    iterator_impl &operator--() noexcept
+      requires Bidirectional
+    {
+      m_it = m_it == nullptr ? m_list->m_tail : m_it->get_prev();
+      assert(m_it != nullptr);
+      return *this;
+    }
+    iterator_impl operator--(int) noexcept
+      requires Bidirectional
+    {
+      auto copy{*this};
+      --*this;
+      return copy;
+    }
+
+    // Moves `steps` elements forward in O(log steps) on indexed lists,
+    // where `std::advance` would walk them one by one.
+    iterator_impl &operator+=(difference_type steps) noexcept
+      requires Indexed
+    {
+      assert(steps >= 0);
+      m_it = skip_forward(m_it, static_cast<size_type>(steps));
+      return *this;
+    }
+    iterator_impl operator+(difference_type steps) const noexcept
+      requires Indexed
+    {
+      auto copy{*this};
+      return copy += steps;
+    }
+
   private:
+    friend class skip_list;
+
+    struct no_list {};
+
     IteratorValueType *m_it{nullptr};
+    [[no_unique_address]] std::conditional_t<Bidirectional, const skip_list *,
+                                             no_list> m_list{};
   };
 };
 
+namespace detail {
+// Lets the set algebra reach the private `skip_list::combine`.
+struct set_algebra {
+  template <bool OnlyLhs, bool OnlyRhs, bool Both, typename SkipList>
+  static SkipList combine(const SkipList &lhs, const SkipList &rhs) {
+    return SkipList::template combine<OnlyLhs, OnlyRhs, Both>(lhs, rhs);
+  }
+};
+} // namespace detail
+
+// Set algebra as in the std algorithms of the same name: equivalent
+// elements are matched one to one and kept from `lhs` when both lists hold
+// them. A run of elements without a match is skipped or copied with one
+// finger search, so intersecting k elements with n costs O(k log(n / k))
+// comparisons. The result is built by appending, with the allocator and
+// comparator of `lhs`. Declared in `sl`, so both `sl::set_union(lhs, rhs)`
+// and the unqualified call found by argument dependent lookup work.
+template <typename T, typename Compare, int ProbabilityInt,
+          std::size_t MaxNodeSize, typename Allocator, typename LevelGenerator,
+          typename NodePool, bool Indexed, bool Bidirectional>
+skip_list<T, Compare, ProbabilityInt, MaxNodeSize, Allocator, LevelGenerator,
+          NodePool, Indexed, Bidirectional>
+set_union(
+    const skip_list<T, Compare, ProbabilityInt, MaxNodeSize, Allocator,
+                    LevelGenerator, NodePool, Indexed, Bidirectional> &lhs,
+    const skip_list<T, Compare, ProbabilityInt, MaxNodeSize, Allocator,
+                    LevelGenerator, NodePool, Indexed, Bidirectional> &rhs) {
+  return detail::set_algebra::combine<true, true, true>(lhs, rhs);
+}
+
+template <typename T, typename Compare, int ProbabilityInt,
+          std::size_t MaxNodeSize, typename Allocator, typename LevelGenerator,
+          typename NodePool, bool Indexed, bool Bidirectional>
+skip_list<T, Compare, ProbabilityInt, MaxNodeSize, Allocator, LevelGenerator,
+          NodePool, Indexed, Bidirectional>
+set_intersection(
+    const skip_list<T, Compare, ProbabilityInt, MaxNodeSize, Allocator,
+                    LevelGenerator, NodePool, Indexed, Bidirectional> &lhs,
+    const skip_list<T, Compare, ProbabilityInt, MaxNodeSize, Allocator,
+                    LevelGenerator, NodePool, Indexed, Bidirectional> &rhs) {
+  return detail::set_algebra::combine<false, false, true>(lhs, rhs);
+}
+
+template <typename T, typename Compare, int ProbabilityInt,
+          std::size_t MaxNodeSize, typename Allocator, typename LevelGenerator,
+          typename NodePool, bool Indexed, bool Bidirectional>
+skip_list<T, Compare, ProbabilityInt, MaxNodeSize, Allocator, LevelGenerator,
+          NodePool, Indexed, Bidirectional>
+set_difference(
+    const skip_list<T, Compare, ProbabilityInt, MaxNodeSize, Allocator,
+                    LevelGenerator, NodePool, Indexed, Bidirectional> &lhs,
+    const skip_list<T, Compare, ProbabilityInt, MaxNodeSize, Allocator,
+                    LevelGenerator, NodePool, Indexed, Bidirectional> &rhs) {
+  return detail::set_algebra::combine<true, false, false>(lhs, rhs);
+}
+
+template <typename T, typename Compare, int ProbabilityInt,
+          std::size_t MaxNodeSize, typename Allocator, typename LevelGenerator,
+          typename NodePool, bool Indexed, bool Bidirectional>
+skip_list<T, Compare, ProbabilityInt, MaxNodeSize, Allocator, LevelGenerator,
+          NodePool, Indexed, Bidirectional>
+set_symmetric_difference(
+    const skip_list<T, Compare, ProbabilityInt, MaxNodeSize, Allocator,
+                    LevelGenerator, NodePool, Indexed, Bidirectional> &lhs,
+    const skip_list<T, Compare, ProbabilityInt, MaxNodeSize, Allocator,
+                    LevelGenerator, NodePool, Indexed, Bidirectional> &rhs) {
+  return detail::set_algebra::combine<true, true, false>(lhs, rhs);
+}
+
 template <typename T, typename CompareLhs, typename CompareRhs, int ProbLhs,
           int ProbRhs, std::size_t MaxNodeSizeLhs, std::size_t MaxNodeSizeRhs,
-          typename Allocator = std::allocator<T>>
+          typename Allocator, typename LevelGeneratorLhs,
+          typename LevelGeneratorRhs, typename NodePoolLhs,
+          typename NodePoolRhs, bool IndexedLhs, bool IndexedRhs,
+          bool BidirectionalLhs, bool BidirectionalRhs>
 bool operator==(
-    const skip_list<T, CompareLhs, ProbLhs, MaxNodeSizeLhs, Allocator> &lhs,
-    const skip_list<T, CompareRhs, ProbRhs, MaxNodeSizeRhs, Allocator>
-        &rhs) noexcept {
+    const skip_list<T, CompareLhs, ProbLhs, MaxNodeSizeLhs, Allocator,
+                    LevelGeneratorLhs, NodePoolLhs, IndexedLhs,
+                    BidirectionalLhs> &lhs,
+    const skip_list<T, CompareRhs, ProbRhs, MaxNodeSizeRhs, Allocator,
+                    LevelGeneratorRhs, NodePoolRhs, IndexedRhs,
+                    BidirectionalRhs> &rhs) noexcept {
   return std::equal(lhs.cbegin(), lhs.cend(), rhs.cbegin(), rhs.cend());
 }
 
 template <typename T, typename CompareLhs, typename CompareRhs, int ProbLhs,
           int ProbRhs, std::size_t MaxNodeSizeLhs, std::size_t MaxNodeSizeRhs,
-          typename Allocator = std::allocator<T>>
+          typename Allocator, typename LevelGeneratorLhs,
+          typename LevelGeneratorRhs, typename NodePoolLhs,
+          typename NodePoolRhs, bool IndexedLhs, bool IndexedRhs,
+          bool BidirectionalLhs, bool BidirectionalRhs>
 auto operator<=>(
-    const skip_list<T, CompareLhs, ProbLhs, MaxNodeSizeLhs, Allocator> &lhs,
-    const skip_list<T, CompareRhs, ProbRhs, MaxNodeSizeRhs, Allocator>
-        &rhs) noexcept {
+    const skip_list<T, CompareLhs, ProbLhs, MaxNodeSizeLhs, Allocator,
+                    LevelGeneratorLhs, NodePoolLhs, IndexedLhs,
+                    BidirectionalLhs> &lhs,
+    const skip_list<T, CompareRhs, ProbRhs, MaxNodeSizeRhs, Allocator,
+                    LevelGeneratorRhs, NodePoolRhs, IndexedRhs,
+                    BidirectionalRhs> &rhs) noexcept {
   return std::lexicographical_compare_three_way(
       lhs.cbegin(), lhs.cend(), rhs.cbegin(), rhs.cend(),
       [](const T &lhs_l, const T &rhs_l) { return lhs_l <=> rhs_l; });
 }
 
+namespace pmr {
+template <typename T, typename Compare = std::less<T>,
+          int ProbabilityInt = DEFAULT_PROBABILITY,
+          std::size_t MaxNodeSize = DEFAULT_MAX_NODE_SIZE,
+          typename LevelGenerator =
+              geometric_level_generator<ProbabilityInt, MaxNodeSize>,
+          typename NodePool = no_node_pool, bool Indexed = false,
+          bool Bidirectional = false>
+using skip_list = sl::skip_list<T, Compare, ProbabilityInt, MaxNodeSize,
+                                std::pmr::polymorphic_allocator<T>,
+                                LevelGenerator, NodePool, Indexed,
+                                Bidirectional>;
+} // namespace pmr
+
+// Keeps the width of every link, so positions are found in O(log n): `nth`,
+// `operator[]`, `rank`, `index_of`, `distance`, `sample` and `it + n`.
+// Iterators are not random access, as a step back or a difference of two
+// iterators would need the list, so `std::advance` and `std::distance` stay
+// linear.
+template <typename T, typename Compare = std::less<T>,
+          int ProbabilityInt = DEFAULT_PROBABILITY,
+          std::size_t MaxNodeSize = DEFAULT_MAX_NODE_SIZE,
+          typename Allocator = std::allocator<T>,
+          typename NodePool = no_node_pool>
+using indexed_skip_list =
+    skip_list<T, Compare, ProbabilityInt, MaxNodeSize, Allocator,
+              geometric_level_generator<ProbabilityInt, MaxNodeSize>,
+              NodePool, true>;
+
+// Keeps a back link on level 0, so iterators are bidirectional, `rbegin()`
+// and `rend()` scan from the tail and an element is erased by position
+// without comparing values.
+template <typename T, typename Compare = std::less<T>,
+          int ProbabilityInt = DEFAULT_PROBABILITY,
+          std::size_t MaxNodeSize = DEFAULT_MAX_NODE_SIZE,
+          typename Allocator = std::allocator<T>,
+          typename NodePool = no_node_pool>
+using bidirectional_skip_list =
+    skip_list<T, Compare, ProbabilityInt, MaxNodeSize, Allocator,
+              geometric_level_generator<ProbabilityInt, MaxNodeSize>,
+              NodePool, false, true>;
+
+// Ordered map with unique keys, on a skip list of its entries. Entries are
+// searched by key alone and their values can be changed through iterators.
+template <typename Key, typename Value, typename Compare = std::less<Key>,
+          int ProbabilityInt = DEFAULT_PROBABILITY,
+          std::size_t MaxNodeSize = DEFAULT_MAX_NODE_SIZE,
+          typename Allocator = std::allocator<std::pair<const Key, Value>>,
+          typename NodePool = no_node_pool>
+class skip_map {
+public:
+  using key_type = Key;
+  using mapped_type = Value;
+  using value_type = std::pair<const Key, Value>;
+  using key_compare = Compare;
+  using allocator_type = Allocator;
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+  using reference = value_type &;
+  using const_reference = const value_type &;
+
+private:
+  using list_type =
+      skip_list<value_type, detail::entry_compare<Key, Value, Compare>,
+                ProbabilityInt, MaxNodeSize, Allocator,
+                geometric_level_generator<ProbabilityInt, MaxNodeSize>,
+                NodePool>;
+
+public:
+  using const_iterator = typename list_type::const_iterator;
+
+  class iterator {
+  public:
+    using difference_type = std::ptrdiff_t;
+    using value_type = skip_map::value_type;
+
+    iterator() noexcept = default;
+
+    // Entries are never const objects, only their key is.
+    value_type &operator*() const noexcept {
+      // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
+      return const_cast<value_type &>(*m_it);
+    }
+    value_type *operator->() const noexcept { return &**this; }
+
+    iterator &operator++() noexcept {
+      ++m_it;
+      return *this;
+    }
+    iterator operator++(int) noexcept {
+      auto copy{*this};
+      ++m_it;
+      return copy;
+    }
+
+    bool operator==(const iterator &rhs) const { return m_it == rhs.m_it; }
+
+    operator const_iterator() const noexcept { return m_it; }
+
+  private:
+    friend class skip_map;
+
+    explicit iterator(const_iterator it) noexcept : m_it(it) {}
+
+    const_iterator m_it;
+  };
+
+  skip_map() = default;
+
+  explicit skip_map(const Compare &comp, const Allocator &alloc = Allocator())
+      : m_list(entry_compare{comp}, alloc) {}
+
+  explicit skip_map(const Allocator &alloc) : m_list(alloc) {}
+
+  // Of entries with equivalent keys only the first is kept.
+  template <class InputIt>
+    requires(!std::is_same_v<typename std::iterator_traits<InputIt>::value_type,
+                             void>)
+  skip_map(InputIt first, InputIt last, const Compare &comp = Compare(),
+           const Allocator &alloc = Allocator())
+      : skip_map(comp, alloc) {
+    insert(first, last);
+  }
+
+  skip_map(std::initializer_list<value_type> init,
+           const Compare &comp = Compare(),
+           const Allocator &alloc = Allocator())
+      : skip_map(init.begin(), init.end(), comp, alloc) {}
+
+  allocator_type get_allocator() const noexcept {
+    return m_list.get_allocator();
+  }
+
+  iterator begin() noexcept { return iterator{m_list.begin()}; }
+  const_iterator begin() const noexcept { return m_list.begin(); }
+  const_iterator cbegin() const noexcept { return m_list.cbegin(); }
+
+  iterator end() noexcept { return iterator{m_list.end()}; }
+  const_iterator end() const noexcept { return m_list.end(); }
+  const_iterator cend() const noexcept { return m_list.cend(); }
+
+  size_type size() const noexcept { return m_list.size(); }
+  bool empty() const noexcept { return m_list.empty(); }
+
+  void clear() { m_list.clear_elements(); }
+
+  template <class SeedSeq> void set_seed(SeedSeq &seed) {
+    m_list.set_seed(seed);
+  }
+
+  void swap(skip_map &other) noexcept { m_list.swap(other.m_list); }
+
+  friend void swap(skip_map &lhs, skip_map &rhs) noexcept { lhs.swap(rhs); }
+
+  // Builds the value from `args` only when `key` is absent, in one descent.
+  template <typename... Args>
+  std::pair<iterator, bool> try_emplace(const Key &key, Args &&...args) {
+    return wrap(m_list.emplace_unique(
+        key, std::piecewise_construct, std::forward_as_tuple(key),
+        std::forward_as_tuple(std::forward<Args>(args)...)));
+  }
+
+  template <typename... Args>
+  std::pair<iterator, bool> try_emplace(Key &&key, Args &&...args) {
+    return wrap(m_list.emplace_unique(
+        key, std::piecewise_construct, std::forward_as_tuple(std::move(key)),
+        std::forward_as_tuple(std::forward<Args>(args)...)));
+  }
+
+  // Assigns `obj` to the value of `key`, or inserts both when the key is
+  // absent, in one descent.
+  template <typename M>
+  std::pair<iterator, bool> insert_or_assign(const Key &key, M &&obj) {
+    return assign_or_emplace(key, key, std::forward<M>(obj));
+  }
+
+  template <typename M>
+  std::pair<iterator, bool> insert_or_assign(Key &&key, M &&obj) {
+    return assign_or_emplace(key, std::move(key), std::forward<M>(obj));
+  }
+
+  std::pair<iterator, bool> insert(const value_type &value) {
+    return wrap(m_list.emplace_unique(value.first, value));
+  }
+
+  std::pair<iterator, bool> insert(value_type &&value) {
+    return wrap(m_list.emplace_unique(value.first, std::move(value)));
+  }
+
+  template <typename InputIt> void insert(InputIt first, InputIt last) {
+    for (; first != last; ++first) {
+      insert(*first);
+    }
+  }
+
+  // Value of `key`, default constructed first if the key is absent.
+  Value &operator[](const Key &key) { return try_emplace(key).first->second; }
+  Value &operator[](Key &&key) {
+    return try_emplace(std::move(key)).first->second;
+  }
+
+  Value &at(const Key &key) {
+    auto it{find(key)};
+    if (it == end()) {
+      throw std::out_of_range("sl::skip_map::at: key not found");
+    }
+    return it->second;
+  }
+  const Value &at(const Key &key) const {
+    auto it{find(key)};
+    if (it == end()) {
+      throw std::out_of_range("sl::skip_map::at: key not found");
+    }
+    return it->second;
+  }
+
+  iterator find(const Key &key) { return iterator{m_list.find(key)}; }
+  const_iterator find(const Key &key) const { return m_list.find(key); }
+
+  template <typename K>
+    requires detail::transparent_comparator<Compare>
+  iterator find(const K &key) {
+    return iterator{m_list.find(key)};
+  }
+  template <typename K>
+    requires detail::transparent_comparator<Compare>
+  const_iterator find(const K &key) const {
+    return m_list.find(key);
+  }
+
+  bool contains(const Key &key) const { return m_list.contains(key); }
+
+  template <typename K>
+    requires detail::transparent_comparator<Compare>
+  bool contains(const K &key) const {
+    return m_list.contains(key);
+  }
+
+  size_type count(const Key &key) const { return contains(key) ? 1U : 0U; }
+
+  iterator lower_bound(const Key &key) {
+    return iterator{m_list.lower_bound(key)};
+  }
+  const_iterator lower_bound(const Key &key) const {
+    return m_list.lower_bound(key);
+  }
+
+  iterator upper_bound(const Key &key) {
+    return iterator{m_list.upper_bound(key)};
+  }
+  const_iterator upper_bound(const Key &key) const {
+    return m_list.upper_bound(key);
+  }
+
+  // Returns the number of erased entries, 0 or 1.
+  size_type erase(const Key &key) { return m_list.erase_node(key) ? 1U : 0U; }
+
+  template <typename K>
+    requires detail::transparent_comparator<Compare> &&
+             (!std::convertible_to<const K &, const_iterator>)
+  size_type erase(const K &key) {
+    return m_list.erase_node(key) ? 1U : 0U;
+  }
+
+  iterator erase(const_iterator position) {
+    return iterator{m_list.erase(position)};
+  }
+  iterator erase(iterator position) {
+    return iterator{m_list.erase(position.m_it)};
+  }
+
+  iterator erase(const_iterator first, const_iterator last) {
+    return iterator{m_list.erase(first, last)};
+  }
+
+  friend bool operator==(const skip_map &lhs, const skip_map &rhs) {
+    return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+  }
+
+private:
+  using entry_compare = detail::entry_compare<Key, Value, Compare>;
+
+  static std::pair<iterator, bool>
+  wrap(std::pair<const_iterator, bool> result) noexcept {
+    return {iterator{result.first}, result.second};
+  }
+
+  // `obj` is forwarded once, to the found value or to the new entry.
+  template <typename K, typename M>
+  std::pair<iterator, bool> assign_or_emplace(const Key &key, K &&new_key,
+                                              M &&obj) {
+    typename list_type::search_path path{};
+    if (auto *found{m_list.find_unique(key, path)}) {
+      found->get().second = std::forward<M>(obj);
+      return {iterator{m_list.make_iterator(found)}, false};
+    }
+    return {iterator{m_list.emplace_at(
+                path, std::piecewise_construct,
+                std::forward_as_tuple(std::forward<K>(new_key)),
+                std::forward_as_tuple(std::forward<M>(obj)))},
+            true};
+  }
+
+  list_type m_list;
+};
+
 } // namespace sl
 #endif // SKIP_LIST_SKIP_LIST_HPP_
@@ -0,0 +1,288 @@
+#include <gtest/gtest.h>
+
+#include "skip_list.hpp"
+#include "test_helpers.hpp"
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+using namespace sl;
+using test_helpers::allocation_stats;
+using test_helpers::counting_allocator;
+
+namespace {
+// A counting allocator that propagates with the list, or stays behind.
+template <typename T, bool Propagate>
+struct stateful_allocator : counting_allocator<T> {
+  using propagate_on_container_copy_assignment =
+      std::bool_constant<Propagate>;
+  using propagate_on_container_move_assignment =
+      std::bool_constant<Propagate>;
+  using propagate_on_container_swap = std::bool_constant<Propagate>;
+  template <typename U> struct rebind {
+    using other = stateful_allocator<U, Propagate>;
+  };
+
+  using counting_allocator<T>::counting_allocator;
+  template <typename U>
+  explicit stateful_allocator(
+      const stateful_allocator<U, Propagate> &other) noexcept
+      : counting_allocator<T>(other) {}
+
+  stateful_allocator select_on_container_copy_construction() const {
+    return *this;
+  }
+};
+
+template <bool Propagate>
+using stateful_list =
+    skip_list<int, std::less<int>, DEFAULT_PROBABILITY, DEFAULT_MAX_NODE_SIZE,
+              stateful_allocator<int, Propagate>>;
+
+template <typename SkipList> std::vector<int> to_vector(const SkipList &sl) {
+  return {sl.begin(), sl.end()};
+}
+} // namespace
+
+TEST(Allocators, StatefulAllocatorIsUsed) {
+  allocation_stats stats;
+  {
+    stateful_list<true> sl{stateful_allocator<int, true>(&stats)};
+    ASSERT_EQ(sl.get_allocator().m_stats, &stats);
+    for (int i = 0; i < 100; ++i) {
+      ASSERT_NO_THROW(sl.push(i));
+    }
+    ASSERT_EQ(stats.allocations, 100u);
+    ASSERT_NO_THROW(sl.erase(50));
+    ASSERT_EQ(stats.deallocations, 1u);
+    auto extracted = sl.extract(51);
+    ASSERT_TRUE(extracted.has_value());
+    ASSERT_EQ(stats.deallocations, 2u);
+    ASSERT_NO_THROW(sl.pop_front());
+    ASSERT_NO_THROW(sl.pop_back());
+    ASSERT_EQ(stats.deallocations, 4u);
+    ASSERT_EQ(sl.size(), 96u);
+  }
+  ASSERT_EQ(stats.allocations, stats.deallocations);
+  ASSERT_EQ(stats.live_bytes, 0u);
+}
+
+TEST(Allocators, ClearKeepsAllocator) {
+  allocation_stats stats;
+  stateful_list<true> sl{stateful_allocator<int, true>(&stats)};
+  sl.push({3, 1, 2});
+  ASSERT_NO_THROW(sl.clear());
+  ASSERT_EQ(stats.live_bytes, 0u);
+  ASSERT_EQ(sl.get_allocator().m_stats, &stats);
+  sl.push(4);
+  ASSERT_EQ(stats.allocations, 4u);
+}
+
+TEST(Allocators, CopyConstruction) {
+  allocation_stats stats;
+  allocation_stats other_stats;
+  stateful_list<true> sl{stateful_allocator<int, true>(&stats)};
+  sl.push({3, 1, 2});
+  stateful_list<true> copy(sl);
+  ASSERT_EQ(copy.get_allocator().m_stats, &stats);
+  ASSERT_EQ(stats.allocations, 6u);
+  stateful_list<true> copy_other(sl,
+                                 stateful_allocator<int, true>(&other_stats));
+  ASSERT_EQ(copy_other.get_allocator().m_stats, &other_stats);
+  ASSERT_EQ(other_stats.allocations, 3u);
+  ASSERT_EQ(to_vector(copy_other), to_vector(sl));
+}
+
+TEST(Allocators, CopyAssignmentPropagation) {
+  allocation_stats lhs_stats;
+  allocation_stats rhs_stats;
+  {
+    stateful_list<true> lhs{stateful_allocator<int, true>(&lhs_stats)};
+    stateful_list<true> rhs{stateful_allocator<int, true>(&rhs_stats)};
+    lhs.push({1, 2});
+    rhs.push({3, 4, 5});
+    lhs = rhs;
+    ASSERT_EQ(lhs.get_allocator().m_stats, &rhs_stats);
+    ASSERT_EQ(lhs_stats.live_bytes, 0u);
+    ASSERT_EQ(rhs_stats.allocations, 6u);
+    ASSERT_EQ(to_vector(lhs), to_vector(rhs));
+  }
+  allocation_stats keep_stats;
+  allocation_stats source_stats;
+  stateful_list<false> lhs{stateful_allocator<int, false>(&keep_stats)};
+  stateful_list<false> rhs{stateful_allocator<int, false>(&source_stats)};
+  rhs.push({3, 4, 5});
+  lhs = rhs;
+  ASSERT_EQ(lhs.get_allocator().m_stats, &keep_stats);
+  ASSERT_EQ(keep_stats.allocations, 3u);
+  ASSERT_EQ(to_vector(lhs), to_vector(rhs));
+}
+
+TEST(Allocators, MoveAssignmentPropagation) {
+  allocation_stats lhs_stats;
+  allocation_stats rhs_stats;
+  {
+    stateful_list<true> lhs{stateful_allocator<int, true>(&lhs_stats)};
+    stateful_list<true> rhs{stateful_allocator<int, true>(&rhs_stats)};
+    lhs.push({1, 2});
+    rhs.push({3, 4, 5});
+    const auto *front = &rhs.front();
+    lhs = std::move(rhs);
+    ASSERT_EQ(lhs.get_allocator().m_stats, &rhs_stats);
+    ASSERT_EQ(&lhs.front(), front);
+    ASSERT_EQ(lhs_stats.live_bytes, 0u);
+    ASSERT_EQ(rhs_stats.allocations, 3u);
+  }
+  ASSERT_EQ(rhs_stats.live_bytes, 0u);
+
+  allocation_stats keep_stats;
+  allocation_stats source_stats;
+  {
+    stateful_list<false> lhs{stateful_allocator<int, false>(&keep_stats)};
+    stateful_list<false> rhs{stateful_allocator<int, false>(&source_stats)};
+    rhs.push({3, 4, 5});
+    lhs = std::move(rhs);
+    ASSERT_EQ(lhs.get_allocator().m_stats, &keep_stats);
+    ASSERT_EQ(keep_stats.allocations, 3u);
+    ASSERT_EQ(source_stats.live_bytes, 0u);
+    ASSERT_TRUE(rhs.empty());
+    ASSERT_EQ(to_vector(lhs), (std::vector<int>{3, 4, 5}));
+  }
+  ASSERT_EQ(keep_stats.live_bytes, 0u);
+
+  // Allocators that stay behind but compare equal hand the nodes over.
+  allocation_stats shared_stats;
+  {
+    stateful_list<false> lhs{stateful_allocator<int, false>(&shared_stats)};
+    stateful_list<false> rhs{stateful_allocator<int, false>(&shared_stats)};
+    lhs.push({1, 2});
+    rhs.push({3, 4, 5});
+    const auto *front = &rhs.front();
+    lhs = std::move(rhs);
+    ASSERT_EQ(&lhs.front(), front);
+    ASSERT_EQ(shared_stats.allocations, 5u);
+    ASSERT_EQ(shared_stats.deallocations, 2u);
+    ASSERT_TRUE(rhs.empty());
+    ASSERT_EQ(to_vector(lhs), (std::vector<int>{3, 4, 5}));
+  }
+  ASSERT_EQ(shared_stats.live_bytes, 0u);
+}
+
+TEST(Allocators, MoveConstructionWithAllocator) {
+  allocation_stats stats;
+  allocation_stats other_stats;
+  stateful_list<false> sl{stateful_allocator<int, false>(&stats)};
+  sl.push({3, 1, 2});
+  const auto *front = &sl.front();
+  stateful_list<false> same(std::move(sl),
+                            stateful_allocator<int, false>(&stats));
+  ASSERT_EQ(&same.front(), front);
+  ASSERT_EQ(stats.allocations, 3u);
+  stateful_list<false> other(std::move(same),
+                             stateful_allocator<int, false>(&other_stats));
+  ASSERT_EQ(other_stats.allocations, 3u);
+  ASSERT_EQ(stats.live_bytes, 0u);
+  ASSERT_EQ(to_vector(other), (std::vector<int>{1, 2, 3}));
+}
+
+TEST(Allocators, MergeWithDifferentAllocators) {
+  allocation_stats stats;
+  allocation_stats other_stats;
+  stateful_list<false> sl{stateful_allocator<int, false>(&stats)};
+  sl.push({1, 3, 5});
+  {
+    stateful_list<false> other{stateful_allocator<int, false>(&other_stats)};
+    other.push({2, 4});
+    ASSERT_NO_THROW(sl.merge(other));
+    ASSERT_TRUE(other.empty());
+    ASSERT_EQ(other_stats.live_bytes, 0u);
+  }
+  ASSERT_EQ(stats.allocations, 5u);
+  ASSERT_EQ(to_vector(sl), (std::vector<int>{1, 2, 3, 4, 5}));
+  stateful_list<false> same{stateful_allocator<int, false>(&stats)};
+  same.push({0, 6});
+  ASSERT_NO_THROW(sl.merge(same));
+  ASSERT_EQ(stats.allocations, 7u);
+  ASSERT_EQ(to_vector(sl), (std::vector<int>{0, 1, 2, 3, 4, 5, 6}));
+}
+
+TEST(Allocators, JoinWithDifferentAllocators) {
+  allocation_stats stats;
+  allocation_stats other_stats;
+  stateful_list<false> sl{stateful_allocator<int, false>(&stats)};
+  sl.push({1, 3, 5});
+  stateful_list<false> other{stateful_allocator<int, false>(&other_stats)};
+  other.push({5, 6, 9});
+  ASSERT_NO_THROW(sl.join(other));
+  ASSERT_TRUE(other.empty());
+  ASSERT_EQ(other_stats.live_bytes, 0u);
+  ASSERT_EQ(stats.allocations, 6u);
+  ASSERT_EQ(to_vector(sl), (std::vector<int>{1, 3, 5, 5, 6, 9}));
+  auto suffix = sl.split(5);
+  ASSERT_EQ(suffix.get_allocator(), sl.get_allocator());
+  ASSERT_EQ(stats.allocations, 6u);
+  ASSERT_EQ(to_vector(suffix), (std::vector<int>{5, 5, 6, 9}));
+}
+
+TEST(Allocators, SwapPropagation) {
+  allocation_stats lhs_stats;
+  allocation_stats rhs_stats;
+  stateful_list<true> lhs{stateful_allocator<int, true>(&lhs_stats)};
+  stateful_list<true> rhs{stateful_allocator<int, true>(&rhs_stats)};
+  lhs.push({1, 2});
+  rhs.push({3, 4, 5});
+  swap(lhs, rhs);
+  ASSERT_EQ(lhs.get_allocator().m_stats, &rhs_stats);
+  ASSERT_EQ(rhs.get_allocator().m_stats, &lhs_stats);
+  ASSERT_EQ(to_vector(lhs), (std::vector<int>{3, 4, 5}));
+  ASSERT_EQ(to_vector(rhs), (std::vector<int>{1, 2}));
+}
+
+TEST(Allocators, PmrMonotonicBuffer) {
+  std::array<std::byte, 1u << 14u> buffer{};
+  std::pmr::monotonic_buffer_resource resource(
+      buffer.data(), buffer.size(), std::pmr::null_memory_resource());
+  {
+    sl::pmr::skip_list<int> sl(&resource);
+    ASSERT_EQ(sl.get_allocator().resource(), &resource);
+    for (int i = 100; i > 0; --i) {
+      ASSERT_NO_THROW(sl.push(i));
+    }
+    ASSERT_NO_THROW(sl.erase(50));
+    ASSERT_EQ(sl.size(), 99u);
+    ASSERT_EQ(sl.front(), 1);
+    ASSERT_EQ(sl.back(), 100);
+    for (const auto &value : sl) {
+      const auto *address = reinterpret_cast<const std::byte *>(&value);
+      ASSERT_GE(address, buffer.data());
+      ASSERT_LT(address, buffer.data() + buffer.size());
+    }
+  }
+  ASSERT_THROW(
+      {
+        sl::pmr::skip_list<int> sl(std::pmr::null_memory_resource());
+        sl.push(1);
+      },
+      std::bad_alloc);
+}
+
+TEST(Allocators, PmrPropagatesToElements) {
+  std::array<std::byte, 1u << 14u> buffer{};
+  std::pmr::monotonic_buffer_resource resource(
+      buffer.data(), buffer.size(), std::pmr::null_memory_resource());
+  sl::pmr::skip_list<std::pmr::string> sl(&resource);
+  sl.push(std::pmr::string("a string long enough to allocate memory"));
+  sl.push("b another string long enough to allocate memory");
+  ASSERT_EQ(sl.size(), 2u);
+  for (const auto &value : sl) {
+    ASSERT_EQ(value.get_allocator().resource(), &resource);
+  }
+  const auto same_type =
+      std::is_same_v<decltype(sl)::allocator_type,
+                     std::pmr::polymorphic_allocator<std::pmr::string>>;
+  ASSERT_TRUE(same_type);
+}
@@ -0,0 +1,231 @@
+#include <gtest/gtest.h>
+
+#include "skip_list.hpp"
+#include "test_helpers.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <set>
+#include <vector>
+
+using namespace sl;
+using test_helpers::counting_less;
+using test_helpers::random_values;
+
+namespace {
+template <typename SkipList, typename Expected>
+void check_list(const SkipList &sl, const Expected &expected) {
+  ASSERT_EQ(sl.size(), expected.size());
+  ASSERT_TRUE(
+      std::equal(sl.begin(), sl.end(), expected.begin(), expected.end()));
+  for (auto value : expected) {
+    const auto found = sl.find(value);
+    ASSERT_NE(found, sl.end());
+    ASSERT_EQ(*found, value);
+  }
+}
+} // namespace
+
+TEST(Batch, InsertSorted) {
+  skip_list<int> sl{10, 20, 30};
+  const std::vector<int> values{0, 5, 10, 10, 25, 30, 40, 50};
+  sl.insert_sorted(values.begin(), values.end());
+  check_list(sl, std::vector<int>{0, 5, 10, 10, 10, 20, 25, 30, 30, 40, 50});
+  skip_list<int> empty;
+  empty.insert_sorted(values.begin(), values.end());
+  check_list(empty, values);
+  empty.insert_sorted(values.begin(), values.begin());
+  ASSERT_EQ(empty.size(), values.size());
+}
+
+TEST(Batch, InsertSortedRandomized) {
+  skip_list<int> sl;
+  std::multiset<int> expected;
+  for (unsigned round = 0u; round < 20u; ++round) {
+    auto values = random_values(500u, 2000, round);
+    // Every fourth batch is left unsorted.
+    if (round % 4u != 0u) {
+      std::sort(values.begin(), values.end());
+    }
+    sl.insert_sorted(values.begin(), values.end());
+    expected.insert(values.begin(), values.end());
+    check_list(sl, expected);
+  }
+  sl.push(-1);
+  sl.push(2001);
+  ASSERT_EQ(sl.front(), -1);
+  ASSERT_EQ(sl.back(), 2001);
+}
+
+TEST(Batch, InsertSortedBeforeEquivalent) {
+  auto comp = [](const std::pair<int, int> &lhs,
+                 const std::pair<int, int> &rhs) {
+    return lhs.first < rhs.first;
+  };
+  using pair_list = skip_list<std::pair<int, int>, decltype(comp)>;
+  pair_list sl{{1, 0}, {2, 0}};
+  pair_list one_by_one(sl);
+  const std::vector<std::pair<int, int>> values{{1, 1}, {1, 2}, {2, 1}};
+  sl.insert_sorted(values.begin(), values.end());
+  ASSERT_EQ((std::vector<std::pair<int, int>>(sl.begin(), sl.end())),
+            (std::vector<std::pair<int, int>>{
+                {1, 2}, {1, 1}, {1, 0}, {2, 1}, {2, 0}}));
+  // Equivalent values land where `insert` puts them.
+  for (const auto &value : values) {
+    one_by_one.insert(value);
+  }
+  ASSERT_TRUE(std::equal(sl.begin(), sl.end(), one_by_one.begin(),
+                         one_by_one.end()));
+}
+
+TEST(Batch, DenseBatchIsNearLinear) {
+  constexpr int SIZE = 10000;
+  std::size_t calls = 0u;
+  skip_list<int, counting_less, DEFAULT_PROBABILITY, 16u> sl(
+      counting_less{&calls}, std::allocator<int>{});
+  std::seed_seq seed{11};
+  sl.set_seed(seed);
+  std::vector<int> evens;
+  std::vector<int> odds;
+  for (int i = 0; i < SIZE; ++i) {
+    evens.push_back(2 * i);
+    odds.push_back(2 * i + 1);
+  }
+  sl.assign(evens.begin(), evens.end());
+  calls = 0u;
+  sl.insert_sorted(odds.begin(), odds.end());
+  ASSERT_EQ(sl.size(), 2u * SIZE);
+  // A search from the head alone costs about 2 * log2(n), i.e. 28, comparisons.
+  ASSERT_LT(calls, 12u * SIZE);
+  int expected = 0;
+  for (auto value : sl) {
+    ASSERT_EQ(value, expected++);
+  }
+
+  calls = 0u;
+  std::vector<decltype(sl)::const_iterator> iterators;
+  sl.find_many(odds.begin(), odds.end(), std::back_inserter(iterators));
+  ASSERT_LT(calls, 12u * SIZE);
+  ASSERT_EQ(iterators.size(), odds.size());
+  for (std::size_t i = 0u; i < odds.size(); ++i) {
+    ASSERT_NE(iterators[i], sl.end());
+    ASSERT_EQ(*iterators[i], odds[i]);
+  }
+
+  calls = 0u;
+  ASSERT_EQ(sl.erase_many(evens.begin(), evens.end()), evens.size());
+  ASSERT_LT(calls, 12u * SIZE);
+  ASSERT_TRUE(
+      std::equal(sl.begin(), sl.end(), odds.begin(), odds.end()));
+}
+
+TEST(Batch, FindMany) {
+  const skip_list<int> sl{1, 3, 5, 7, 9};
+  const std::vector<int> keys{0, 1, 2, 5, 5, 9, 10};
+  std::vector<skip_list<int>::const_iterator> found(keys.size());
+  const auto out = sl.find_many(keys.begin(), keys.end(), found.begin());
+  ASSERT_EQ(out, found.end());
+  ASSERT_EQ(found[0], sl.end());
+  ASSERT_EQ(found[1], sl.begin());
+  ASSERT_EQ(found[2], sl.end());
+  ASSERT_EQ(*found[3], 5);
+  ASSERT_EQ(found[3], found[4]);
+  ASSERT_EQ(*found[5], 9);
+  ASSERT_EQ(found[6], sl.end());
+  const std::vector<int> unsorted{9, 1, 7, 4, 3};
+  sl.find_many(unsorted.begin(), unsorted.end(), found.begin());
+  for (std::size_t i = 0u; i < unsorted.size(); ++i) {
+    ASSERT_EQ(found[i], sl.find(unsorted[i]));
+  }
+  const skip_list<int> empty;
+  ASSERT_EQ(empty.find_many(keys.begin(), keys.begin(), found.begin()),
+            found.begin());
+  empty.find_many(keys.begin(), keys.end(), found.begin());
+  ASSERT_EQ(found[0], empty.end());
+}
+
+TEST(Batch, EraseMany) {
+  skip_list<int> sl{1, 2, 2, 3, 5, 8, 13};
+  const std::vector<int> keys{1, 2, 4, 8, 13, 13};
+  ASSERT_EQ(sl.erase_many(keys.begin(), keys.end()), 4u);
+  check_list(sl, std::vector<int>{2, 3, 5});
+  sl.push(0);
+  sl.push(14);
+  check_list(sl, std::vector<int>{0, 2, 3, 5, 14});
+  const std::vector<int> all{0, 2, 3, 5, 14};
+  ASSERT_EQ(sl.erase_many(all.begin(), all.end()), 5u);
+  ASSERT_TRUE(sl.empty());
+  ASSERT_EQ(sl.begin(), sl.end());
+  ASSERT_EQ(sl.erase_many(all.begin(), all.end()), 0u);
+  sl.push(4);
+  check_list(sl, std::vector<int>{4});
+}
+
+TEST(Batch, EraseManyRandomized) {
+  skip_list<int> sl;
+  std::multiset<int> expected;
+  const auto values = random_values(5000u, 3000, 5u);
+  sl.insert(values.begin(), values.end());
+  expected.insert(values.begin(), values.end());
+  for (unsigned round = 0u; round < 10u; ++round) {
+    auto keys = random_values(300u, 3000, 100u + round);
+    if (round % 3u != 0u) {
+      std::sort(keys.begin(), keys.end());
+    }
+    std::size_t erased = 0u;
+    for (auto key : keys) {
+      const auto found = expected.find(key);
+      if (found != expected.end()) {
+        expected.erase(found);
+        ++erased;
+      }
+    }
+    ASSERT_EQ(sl.erase_many(keys.begin(), keys.end()), erased);
+    check_list(sl, expected);
+    sl.insert_sorted(keys.begin(), keys.begin() + 50);
+    expected.insert(keys.begin(), keys.begin() + 50);
+    check_list(sl, expected);
+  }
+}
+
+TEST(Batch, FindBatch) {
+  skip_list<int> sl;
+  // Large enough to be interleaved rather than searched key by key.
+  constexpr auto size = skip_list<int>::batch_min_size + 1u;
+  const auto values = random_values(size, 120000, 21u);
+  sl.insert(values.begin(), values.end());
+  ASSERT_GE(sl.size(), skip_list<int>::batch_min_size);
+  auto keys = random_values(1000u, 120100, 22u);
+  keys.push_back(-1);
+  keys.push_back(sl.front());
+  keys.push_back(sl.back());
+  std::vector<skip_list<int>::const_iterator> found(keys.size());
+  sl.find_batch(keys, found);
+  for (std::size_t i = 0u; i < keys.size(); ++i) {
+    const auto expected = sl.find(keys[i]);
+    ASSERT_EQ(found[i] == sl.end(), expected == sl.end());
+    if (found[i] != sl.end()) {
+      ASSERT_EQ(*found[i], keys[i]);
+    }
+  }
+  std::vector<skip_list<int>::const_iterator> one_by_one(keys.size());
+  sl.find_batch<1u>(keys, one_by_one);
+  ASSERT_EQ(found, one_by_one);
+}
+
+TEST(Batch, FindBatchSmall) {
+  const skip_list<int> sl{2, 4, 6};
+  const std::vector<int> keys{6, 1, 4, 7};
+  std::vector<skip_list<int>::const_iterator> found(keys.size());
+  sl.find_batch(keys, found);
+  ASSERT_EQ(*found[0], 6);
+  ASSERT_EQ(found[1], sl.end());
+  ASSERT_EQ(*found[2], 4);
+  ASSERT_EQ(found[3], sl.end());
+  ASSERT_NO_THROW(sl.find_batch({}, {}));
+  const skip_list<int> empty;
+  empty.find_batch(keys, found);
+  for (const auto &it : found) {
+    ASSERT_EQ(it, empty.end());
+  }
+}
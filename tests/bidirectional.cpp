@@ -0,0 +1,154 @@
+#include <gtest/gtest.h>
+
+#include "skip_list.hpp"
+#include "test_helpers.hpp"
+#include <algorithm>
+#include <iterator>
+#include <random>
+#include <utility>
+#include <vector>
+
+using namespace sl;
+
+namespace {
+template <typename SkipList> std::vector<int> backwards(const SkipList &sl) {
+  std::vector<int> values;
+  for (auto it = sl.end(); it != sl.begin();) {
+    --it;
+    values.push_back(*it);
+  }
+  return values;
+}
+
+// The back links must mirror the forward ones.
+template <typename SkipList> void check_links(const SkipList &sl) {
+  std::vector<int> forward(sl.begin(), sl.end());
+  ASSERT_EQ(forward.size(), sl.size());
+  std::vector<int> reversed(sl.rbegin(), sl.rend());
+  std::reverse(reversed.begin(), reversed.end());
+  ASSERT_EQ(forward, reversed);
+  auto expected = backwards(sl);
+  std::reverse(expected.begin(), expected.end());
+  ASSERT_EQ(forward, expected);
+}
+
+template <typename SkipList> void check_updates() {
+  std::mt19937 gen(7);
+  std::uniform_int_distribution<int> value(0, 50);
+  SkipList sl;
+  std::seed_seq SEED{3};
+  sl.set_seed(SEED);
+  for (int i = 0; i < 300; ++i) {
+    sl.insert(value(gen));
+  }
+  check_links(sl);
+  for (int i = 0; i < 100; ++i) {
+    sl.insert(sl.begin(), value(gen));
+    sl.erase(value(gen));
+  }
+  check_links(sl);
+  std::vector<int> keys{1, 5, 5, 9, 40};
+  sl.insert_sorted(keys.begin(), keys.end());
+  sl.erase_many(keys.begin(), keys.end());
+  check_links(sl);
+  auto upper = sl.split(25);
+  check_links(sl);
+  check_links(upper);
+  SkipList other{26, 30, 60};
+  upper.merge(other);
+  check_links(upper);
+  SkipList tail{60, 70, 80};
+  upper.join(tail);
+  check_links(upper);
+  sl.join(upper);
+  check_links(sl);
+  const SkipList copy(sl);
+  check_links(copy);
+  const SkipList rebuilt{5, 1, 4, 2, 3};
+  check_links(rebuilt);
+}
+} // namespace
+
+TEST(Bidirectional, Iteration) {
+  bidirectional_skip_list<int> sl{4, 1, 3, 2};
+  ASSERT_EQ((std::vector<int>(sl.rbegin(), sl.rend())),
+            (std::vector<int>{4, 3, 2, 1}));
+  ASSERT_EQ((std::vector<int>(sl.crbegin(), sl.crend())),
+            (std::vector<int>{4, 3, 2, 1}));
+  auto it = sl.end();
+  ASSERT_EQ(*--it, 4);
+  ASSERT_EQ(*it--, 4);
+  ASSERT_EQ(*it, 3);
+  ASSERT_EQ(*std::prev(sl.end(), 4), 1);
+  ASSERT_EQ(std::prev(sl.end(), 4), sl.begin());
+  // Latest two entries, scanned from the tail.
+  ASSERT_EQ((std::vector<int>(sl.rbegin(), std::next(sl.rbegin(), 2))),
+            (std::vector<int>{4, 3}));
+  const bidirectional_skip_list<int> empty;
+  ASSERT_EQ(empty.rbegin(), empty.rend());
+}
+
+TEST(Bidirectional, LinksFollowUpdates) {
+  check_updates<test_helpers::layout_list<int, false, true>>();
+  check_updates<test_helpers::layout_list<int, true, true>>();
+  check_updates<test_helpers::layout_list<int, false, true, std::less<int>,
+                                          std::allocator<int>,
+                                          DEFAULT_MAX_NODE_SIZE,
+                                          slab_node_pool<8>>>();
+}
+
+TEST(Bidirectional, PopBoth) {
+  bidirectional_skip_list<int> sl;
+  for (int i = 0; i < 200; ++i) {
+    sl.insert(sl.end(), i);
+  }
+  for (int i = 0; i < 50; ++i) {
+    sl.pop_back();
+    sl.pop_front();
+  }
+  ASSERT_EQ(sl.size(), 100u);
+  ASSERT_EQ(sl.front(), 50);
+  ASSERT_EQ(sl.back(), 149);
+  check_links(sl);
+  for (int key = 50; key < 150; ++key) {
+    ASSERT_NE(sl.find(key), sl.end());
+  }
+  while (!sl.empty()) {
+    sl.pop_back();
+  }
+  ASSERT_EQ(sl.begin(), sl.end());
+}
+
+TEST(Bidirectional, ErasePosition) {
+  auto comp = [](const std::pair<int, int> &lhs,
+                 const std::pair<int, int> &rhs) {
+    return lhs.first < rhs.first;
+  };
+  // Equivalent elements are told apart, the one at the position is erased.
+  const auto erase_each = [](auto sl) {
+    for (int i = 0; i < 100; ++i) {
+      sl.insert(std::make_pair(i % 10, i));
+    }
+    while (!sl.empty()) {
+      auto position = std::next(sl.begin(), static_cast<long>(sl.size() / 2));
+      const auto expected = std::next(position);
+      const auto erased = *position;
+      ASSERT_EQ(sl.erase(position), expected);
+      ASSERT_TRUE(std::none_of(sl.begin(), sl.end(),
+                               [&](const auto &el) { return el == erased; }));
+      if (!sl.empty()) {
+        const auto front = sl.front();
+        const auto second = std::next(sl.begin());
+        ASSERT_EQ(sl.extract(sl.begin()), front);
+        ASSERT_EQ(sl.begin(), second);
+      }
+      for (const auto &el : sl) {
+        ASSERT_NE(sl.find(el), sl.end());
+      }
+    }
+  };
+  using pair = std::pair<int, int>;
+  erase_each(bidirectional_skip_list<pair, decltype(comp)>{});
+  erase_each(skip_list<pair, decltype(comp)>{});
+  erase_each(indexed_skip_list<pair, decltype(comp)>{});
+}
@@ -1,8 +1,23 @@
 #include <gtest/gtest.h>
 
 #include "skip_list.hpp"
+#include "test_helpers.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
 
 using namespace sl;
+using test_helpers::counting_less;
+
+namespace {
+// Structure tests below were written against towers drawn uniformly.
+using uniform_skip_list =
+    skip_list<int, std::less<int>, DEFAULT_PROBABILITY, DEFAULT_MAX_NODE_SIZE,
+              std::allocator<int>,
+              uniform_level_generator<DEFAULT_MAX_NODE_SIZE>>;
+} // namespace
 
 TEST(Erase, Erase) {
   skip_list<int> sl;
@@ -201,7 +216,7 @@ TEST(Erase, EraseAndFind) {
 }
 
 TEST(Erase, WithoutEraseAndInsert) {
-  skip_list<int> sl;
+  uniform_skip_list sl;
   auto emplace = [&](int value, int seed) {
     auto SEED = std::seed_seq({seed});
     sl.set_seed(SEED);
@@ -211,21 +226,21 @@ TEST(Erase, WithoutEraseAndInsert) {
   };
   int i = 0;
   ASSERT_EQ(emplace(0, i++), 0);
-  ASSERT_EQ(emplace(1, i++), 0);
+  ASSERT_EQ(emplace(1, i++), 1);
   ASSERT_EQ(emplace(2, i++), 2);
-  ASSERT_EQ(emplace(3, i++), 2);
-  ASSERT_EQ(emplace(4, i++), 3);
-  ASSERT_EQ(emplace(5, i++), 3);
-  ASSERT_EQ(emplace(6, i++), 3);
-  ASSERT_EQ(emplace(7, i++), 4);
-  ASSERT_EQ(emplace(8, i++), 4);
-  ASSERT_EQ(emplace(9, i++), 5);
+  ASSERT_EQ(emplace(3, i++), 1);
+  ASSERT_EQ(emplace(4, i++), 2);
+  ASSERT_EQ(emplace(5, i++), 2);
+  ASSERT_EQ(emplace(6, i++), 1);
+  ASSERT_EQ(emplace(7, i++), 2);
+  ASSERT_EQ(emplace(8, i++), 2);
+  ASSERT_EQ(emplace(9, i++), 3);
   ASSERT_EQ(emplace(-1, i++), 0);
-  ASSERT_EQ(emplace(10, i++), 6);
-  ASSERT_EQ(emplace(11, i++), 7);
-  ASSERT_EQ(emplace(5, i++), 4);
-  ASSERT_EQ(emplace(15, i++), 7);
-  ASSERT_EQ(emplace(12, i++), 7);
+  ASSERT_EQ(emplace(10, i++), 3);
+  ASSERT_EQ(emplace(11, i++), 4);
+  ASSERT_EQ(emplace(5, i++), 2);
+  ASSERT_EQ(emplace(15, i++), 4);
+  ASSERT_EQ(emplace(12, i++), 4);
   ASSERT_NO_THROW(sl.erase(3));
   ASSERT_NO_THROW(sl.erase(4));
   ASSERT_NO_THROW(sl.erase(5));
@@ -238,13 +253,13 @@ TEST(Erase, WithoutEraseAndInsert) {
   ASSERT_NO_THROW(sl.erase(1));
   ASSERT_NO_THROW(sl.erase(10));
   ASSERT_NO_THROW(sl.erase(9));
-  skip_list<int>::size_type visited = 0;
+  uniform_skip_list::size_type visited = 0;
   ASSERT_NO_THROW(sl.emplace(13, &visited));
-  ASSERT_EQ(visited, 2) << "Skip list balancing error";
+  ASSERT_EQ(visited, 1) << "Skip list balancing error";
 }
 
 TEST(Erase, EraseAndInsert) {
-  skip_list<int> sl;
+  uniform_skip_list sl;
   int seed = 0;
   auto emplace = [&](int value, int should_visit) {
     auto SEED = std::seed_seq({seed++});
@@ -259,23 +274,23 @@ TEST(Erase, EraseAndInsert) {
     ASSERT_EQ(should_visit, visited) << "Value = " << value;
   };
   emplace(0, 0);
-  emplace(1, 0);
+  emplace(1, 1);
   emplace(2, 2);
-  emplace(3, 2);
-  emplace(4, 3);
-  emplace(5, 3);
-  emplace(6, 3);
-  emplace(7, 4);
-  emplace(8, 4);
-  emplace(9, 5);
+  emplace(3, 1);
+  emplace(4, 2);
+  emplace(5, 2);
+  emplace(6, 1);
+  emplace(7, 2);
+  emplace(8, 2);
+  emplace(9, 3);
   emplace(-1, 0);
-  emplace(10, 6);
-  emplace(11, 7);
-  emplace(5, 4);
-  emplace(15, 7);
-  emplace(12, 7);
-  emplace(13, 5);
-  emplace(14, 6);
+  emplace(10, 3);
+  emplace(11, 4);
+  emplace(5, 2);
+  emplace(15, 4);
+  emplace(12, 4);
+  emplace(13, 2);
+  emplace(14, 3);
 
   auto it = sl.begin();
   for (int i = -1; i <= 5; ++i, ++it) {
@@ -440,3 +455,191 @@ TEST(Erase, ExtractUniquePtr) {
   auto not_existing = sl.begin();
   ASSERT_FALSE(sl.extract(not_existing).has_value());
 }
+
+namespace {
+struct counting_priority {
+  bool operator()(const std::pair<int, std::unique_ptr<int>> &lhs,
+                  const std::pair<int, std::unique_ptr<int>> &rhs) const {
+    ++*m_calls;
+    return lhs.first < rhs.first;
+  }
+  std::size_t *m_calls;
+};
+
+// Uses the list as a double-ended priority queue of tasks with many equal
+// priorities, no value may be compared while popping.
+template <typename SkipList> void check_double_ended_queue() {
+  std::size_t calls = 0u;
+  SkipList sl(counting_priority{&calls},
+              std::allocator<std::pair<int, std::unique_ptr<int>>>{});
+  auto SEED = std::seed_seq{5};
+  sl.set_seed(SEED);
+  for (int i = 0; i < 400; ++i) {
+    sl.insert(std::make_pair(i % 7, std::make_unique<int>(i)));
+  }
+  calls = 0u;
+  int front_priority = 0;
+  int back_priority = 6;
+  int popped = 0;
+  while (!sl.empty()) {
+    if (popped % 3 == 0) {
+      const auto *front = sl.front().second.get();
+      auto extracted = sl.extract_front();
+      ASSERT_TRUE(extracted.has_value());
+      ASSERT_EQ(extracted->second.get(), front);
+      ASSERT_GE(extracted->first, front_priority);
+      front_priority = extracted->first;
+    } else if (popped % 3 == 1) {
+      const auto *back = sl.back().second.get();
+      auto extracted = sl.extract_back();
+      ASSERT_TRUE(extracted.has_value());
+      ASSERT_EQ(extracted->second.get(), back);
+      ASSERT_LE(extracted->first, back_priority);
+      back_priority = extracted->first;
+    } else {
+      sl.pop_back();
+    }
+    ++popped;
+    ASSERT_EQ(sl.size(), 400u - static_cast<std::size_t>(popped));
+  }
+  ASSERT_EQ(calls, 0u);
+  ASSERT_FALSE(sl.extract_front().has_value());
+  ASSERT_FALSE(sl.extract_back().has_value());
+  // What is left stays searchable.
+  for (int i = 0; i < 100; ++i) {
+    sl.insert(std::make_pair(i, std::make_unique<int>(i)));
+  }
+  sl.pop_back();
+  sl.pop_front();
+  for (int i = 1; i < 99; ++i) {
+    ASSERT_EQ(*sl.find(std::make_pair(i, nullptr))->second, i);
+  }
+}
+
+template <bool Indexed, bool Bidirectional>
+using task_queue = test_helpers::layout_list<
+    std::pair<int, std::unique_ptr<int>>, Indexed, Bidirectional,
+    counting_priority, std::allocator<std::pair<int, std::unique_ptr<int>>>,
+    8u>;
+} // namespace
+
+TEST(Erase, DoubleEndedQueue) {
+  test_helpers::for_each_layout([]<bool Indexed, bool Bidirectional>() {
+    check_double_ended_queue<task_queue<Indexed, Bidirectional>>();
+  });
+}
+
+namespace {
+template <bool Indexed, bool Bidirectional>
+using counted_list =
+    test_helpers::layout_list<int, Indexed, Bidirectional, counting_less>;
+
+// Expires windows of timestamps, each window is cut with one search.
+template <bool Indexed, bool Bidirectional> void check_erase_range() {
+  std::size_t calls = 0u;
+  counted_list<Indexed, Bidirectional> sl(counting_less{&calls},
+                                          std::allocator<int>{});
+  std::vector<int> expected;
+  for (int i = 0; i < 2000; ++i) {
+    sl.insert(sl.end(), i / 2);
+    expected.push_back(i / 2);
+  }
+  const auto erase_window = [&](int from, int to) {
+    const auto first = sl.lower_bound(from);
+    const auto last = sl.lower_bound(to);
+    calls = 0u;
+    const auto next = sl.erase(first, last);
+    ASSERT_LT(calls, 100u);
+    ASSERT_EQ(next, sl.lower_bound(to));
+    expected.erase(std::lower_bound(expected.begin(), expected.end(), from),
+                   std::lower_bound(expected.begin(), expected.end(), to));
+    ASSERT_EQ(sl.size(), expected.size());
+    ASSERT_TRUE(std::equal(sl.begin(), sl.end(), expected.begin(),
+                           expected.end()));
+  };
+  erase_window(0, 100);
+  erase_window(300, 800);
+  erase_window(950, 1000);
+  erase_window(500, 500);
+  for (const auto &el : expected) {
+    ASSERT_EQ(*sl.find(el), el);
+  }
+  if constexpr (Indexed) {
+    for (std::size_t i = 0u; i < expected.size(); ++i) {
+      ASSERT_EQ(sl[i], expected[i]);
+    }
+  }
+  if constexpr (Bidirectional) {
+    ASSERT_TRUE(std::equal(sl.rbegin(), sl.rend(), expected.rbegin(),
+                           expected.rend()));
+  }
+  ASSERT_EQ(sl.back(), 949);
+  sl.insert(2000);
+  ASSERT_EQ(sl.back(), 2000);
+  ASSERT_EQ(sl.erase(sl.begin(), sl.end()), sl.end());
+  ASSERT_TRUE(sl.empty());
+  sl.insert(1);
+  ASSERT_EQ(sl.front(), 1);
+  ASSERT_EQ(sl.back(), 1);
+}
+} // namespace
+
+TEST(Erase, EraseRange) {
+  test_helpers::for_each_layout([]<bool Indexed, bool Bidirectional>() {
+    check_erase_range<Indexed, Bidirectional>();
+  });
+}
+
+namespace {
+// Erases and extracts the second of three equivalent elements, the search
+// for its predecessors steps over the first one.
+template <bool Indexed> void check_erase_equivalent_position() {
+  using list = test_helpers::layout_list<int, Indexed, false>;
+  for (int seed = 0; seed < 20; ++seed) {
+    for (const bool extract : {false, true}) {
+      list sl;
+      auto SEED = std::seed_seq{seed};
+      sl.set_seed(SEED);
+      sl.push({1, 2, 2, 2, 3});
+      std::vector<const int *> kept;
+      for (const auto &el : sl) {
+        kept.push_back(&el);
+      }
+      const auto it = std::next(sl.lower_bound(2));
+      const auto *removed = &*it;
+      ASSERT_EQ(removed, kept[2]);
+      kept.erase(kept.begin() + 2);
+      if constexpr (Indexed) {
+        ASSERT_EQ(sl.index_of(it), 2u);
+      }
+      if (extract) {
+        const auto extracted = sl.extract(it);
+        ASSERT_TRUE(extracted.has_value());
+        ASSERT_EQ(*extracted, 2);
+      } else {
+        const auto next = sl.erase(it);
+        ASSERT_EQ(&*next, kept[2]);
+      }
+      ASSERT_EQ(sl.size(), 4u);
+      const std::vector<int> expected{1, 2, 2, 3};
+      ASSERT_TRUE(
+          std::equal(sl.begin(), sl.end(), expected.begin(), expected.end()));
+      std::size_t index = 0u;
+      for (auto pos = sl.begin(); pos != sl.end(); ++pos, ++index) {
+        ASSERT_EQ(&*pos, kept[index]);
+        if constexpr (Indexed) {
+          ASSERT_EQ(sl.index_of(pos), index);
+        }
+      }
+      for (const int value : {1, 2, 3}) {
+        ASSERT_EQ(*sl.find(value), value);
+      }
+    }
+  }
+}
+} // namespace
+
+TEST(Erase, EraseEquivalentPosition) {
+  check_erase_equivalent_position<false>();
+  check_erase_equivalent_position<true>();
+}
@@ -1,6 +1,8 @@
 #include <algorithm>
+#include <cstddef>
 #include <gtest/gtest.h>
 #include <random>
+#include <utility>
 
 #include "skip_list.hpp"
 
@@ -151,3 +153,40 @@ TEST(Find, StdFind) {
   ASSERT_NE(find(10), sl.end());
   ASSERT_EQ(*find(10), 10);
 }
+
+TEST(Find, MatchesByEquivalence) {
+  auto comp = [](const std::pair<int, int> &lhs,
+                 const std::pair<int, int> &rhs) {
+    return lhs.first < rhs.first;
+  };
+  skip_list<std::pair<int, int>, decltype(comp)> sl{{1, 0}, {2, 0}, {3, 0}};
+  ASSERT_EQ(*sl.find({2, 7}), std::make_pair(2, 0));
+  ASSERT_EQ(sl.find({4, 0}), sl.end());
+  ASSERT_EQ(*sl.erase({2, 7}), std::make_pair(3, 0));
+  ASSERT_EQ(sl.extract({3, 7}), std::make_pair(3, 0));
+  ASSERT_EQ(sl.size(), 1u);
+}
+
+TEST(Find, OneComparisonPerNode) {
+  std::size_t calls = 0u;
+  auto comp = [&calls](int lhs, int rhs) {
+    ++calls;
+    return lhs < rhs;
+  };
+  constexpr int SIZE = 1 << 12;
+  skip_list<int, decltype(comp), DEFAULT_PROBABILITY, 16> sl(
+      comp, std::allocator<int>{});
+  std::seed_seq SEED{7};
+  sl.set_seed(SEED);
+  for (int i = 0; i < SIZE; ++i) {
+    sl.insert(sl.end(), 2 * i);
+  }
+  calls = 0u;
+  for (int key = -1; key <= 2 * SIZE; ++key) {
+    ASSERT_EQ(sl.find(key) != sl.end(),
+              key >= 0 && key % 2 == 0 && key < 2 * SIZE);
+  }
+  // About 2 log2(n) nodes are visited by a descent with p = 1/2, comparing
+  // each of them once.
+  ASSERT_LT(calls, std::size_t{2 * SIZE + 2} * 28u);
+}
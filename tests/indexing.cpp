@@ -0,0 +1,269 @@
+#include <gtest/gtest.h>
+
+#include "skip_list.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <map>
+#include <random>
+#include <set>
+#include <vector>
+
+using namespace sl;
+
+namespace {
+template <typename T>
+using small_indexed_list =
+    indexed_skip_list<T, std::less<T>, DEFAULT_PROBABILITY, 8u>;
+
+template <typename SkipList, typename Expected>
+void check_positions(const SkipList &sl, const Expected &expected) {
+  ASSERT_EQ(sl.size(), expected.size());
+  ASSERT_TRUE(
+      std::equal(sl.begin(), sl.end(), expected.begin(), expected.end()));
+  std::size_t index = 0u;
+  for (auto it = sl.begin(); it != sl.end(); ++it, ++index) {
+    ASSERT_EQ(sl.nth(index), it);
+    ASSERT_EQ(sl[index], *it);
+    ASSERT_EQ(sl.index_of(it), index);
+    ASSERT_EQ(sl.begin() + static_cast<std::ptrdiff_t>(index), it);
+  }
+  ASSERT_EQ(sl.nth(sl.size()), sl.end());
+  ASSERT_EQ(sl.index_of(sl.end()), sl.size());
+  ASSERT_EQ(sl.begin() + static_cast<std::ptrdiff_t>(sl.size()), sl.end());
+}
+} // namespace
+
+TEST(Indexing, NthAndRank) {
+  indexed_skip_list<int> sl{50, 10, 40, 20, 30};
+  check_positions(sl, std::vector<int>{10, 20, 30, 40, 50});
+  ASSERT_EQ(sl.rank(5), 0u);
+  ASSERT_EQ(sl.rank(10), 0u);
+  ASSERT_EQ(sl.rank(11), 1u);
+  ASSERT_EQ(sl.rank(50), 4u);
+  ASSERT_EQ(sl.rank(51), 5u);
+  ASSERT_EQ(sl.distance(sl.begin(), sl.end()), 5);
+  ASSERT_EQ(sl.distance(sl.nth(1u), sl.nth(3u)), 2);
+  ASSERT_EQ(sl.distance(sl.nth(3u), sl.nth(1u)), -2);
+  auto it = sl.begin();
+  it += 2;
+  ASSERT_EQ(*it, 30);
+  it += 0;
+  ASSERT_EQ(*it, 30);
+  ASSERT_EQ(*(it + 2), 50);
+  indexed_skip_list<int> empty;
+  ASSERT_EQ(empty.nth(0u), empty.end());
+  ASSERT_EQ(empty.rank(1), 0u);
+  ASSERT_EQ(empty.index_of(empty.end()), 0u);
+}
+
+TEST(Indexing, EquivalentElements) {
+  indexed_skip_list<int> sl{1, 2, 2, 2, 3};
+  ASSERT_EQ(sl.rank(2), 1u);
+  auto it = sl.begin();
+  for (std::size_t index = 0u; index < sl.size(); ++index, ++it) {
+    ASSERT_EQ(sl.index_of(it), index);
+  }
+  sl.erase(2);
+  check_positions(sl, std::vector<int>{1, 2, 2, 3});
+}
+
+TEST(Indexing, MaintainedByEveryOperation) {
+  small_indexed_list<int> sl;
+  std::seed_seq seed{5};
+  sl.set_seed(seed);
+  std::multiset<int> expected;
+  std::mt19937 gen(13);
+  std::uniform_int_distribution<int> value(0, 400);
+  for (int round = 0; round < 200; ++round) {
+    const auto v = value(gen);
+    switch (gen() % 8u) {
+    case 0u:
+      sl.emplace(v);
+      expected.insert(v);
+      break;
+    case 1u:
+      sl.insert(sl.lower_bound(v / 2), v);
+      expected.insert(v);
+      break;
+    case 2u: {
+      std::vector<int> values{v, v + 1, v + 7, v + 50};
+      sl.insert_sorted(values.begin(), values.end());
+      expected.insert(values.begin(), values.end());
+      break;
+    }
+    case 3u:
+      if (const auto found = expected.find(v); found != expected.end()) {
+        expected.erase(found);
+      }
+      sl.erase(v);
+      break;
+    case 4u: {
+      std::vector<int> keys{v, v + 3, v + 4, v + 90};
+      for (auto key : keys) {
+        if (const auto found = expected.find(key); found != expected.end()) {
+          expected.erase(found);
+        }
+      }
+      sl.erase_many(keys.begin(), keys.end());
+      break;
+    }
+    case 5u:
+      if (!sl.empty()) {
+        expected.erase(expected.begin());
+        sl.pop_front();
+      }
+      break;
+    case 6u:
+      if (!sl.empty()) {
+        expected.erase(std::prev(expected.end()));
+        sl.pop_back();
+      }
+      break;
+    default: {
+      small_indexed_list<int> other;
+      const auto count = gen() % 2u == 0u ? 3 : 300;
+      for (int i = 0; i < count; ++i) {
+        const auto w = value(gen);
+        other.push(w);
+        expected.insert(w);
+      }
+      sl.merge(other);
+      break;
+    }
+    }
+    check_positions(sl, expected);
+  }
+  const auto copy = sl;
+  check_positions(copy, expected);
+  small_indexed_list<int> built(expected.rbegin(), expected.rend());
+  check_positions(built, expected);
+  small_indexed_list<int> sorted(expected.begin(), expected.end());
+  check_positions(sorted, expected);
+  sl.clear();
+  check_positions(sl, std::vector<int>{});
+  sl.push(3);
+  check_positions(sl, std::vector<int>{3});
+}
+
+TEST(Indexing, NodePool) {
+  indexed_skip_list<int, std::less<int>, DEFAULT_PROBABILITY, 8u,
+                    std::allocator<int>, slab_node_pool<8u>>
+      sl;
+  std::vector<int> expected;
+  for (int i = 0; i < 500; ++i) {
+    sl.push(i);
+    expected.push_back(i);
+  }
+  for (int i = 0; i < 500; i += 3) {
+    sl.erase(i);
+    expected.erase(std::find(expected.begin(), expected.end(), i));
+  }
+  sl.shrink_to_fit();
+  check_positions(sl, expected);
+}
+
+TEST(Indexing, HeaderFollowsTheElements) {
+  std::vector<small_indexed_list<int>> lists;
+  std::vector<int> expected;
+  for (int i = 0; i < 20; ++i) {
+    // Growing the vector moves every list into a new header.
+    lists.emplace_back();
+    for (int j = 0; j <= i; ++j) {
+      lists.back().push(j);
+    }
+  }
+  for (int j = 0; j < 20; ++j) {
+    expected.push_back(j);
+  }
+  check_positions(lists.back(), expected);
+  small_indexed_list<int> other{100, 200};
+  swap(lists.back(), other);
+  check_positions(other, expected);
+  check_positions(lists.back(), std::vector<int>{100, 200});
+  lists.back() = std::move(other);
+  check_positions(lists.back(), expected);
+  check_positions(other, std::vector<int>{});
+  other.push(7);
+  check_positions(other, std::vector<int>{7});
+  while (!lists.back().empty()) {
+    lists.back().pop_front();
+    expected.erase(expected.begin());
+    check_positions(lists.back(), expected);
+  }
+}
+
+TEST(Indexing, SearchesFollowTheTallestTower) {
+  indexed_skip_list<int, std::less<int>, DEFAULT_PROBABILITY, 16u> sl;
+  std::seed_seq seed{11};
+  sl.set_seed(seed);
+  std::vector<int> expected;
+  for (int i = 0; i < 3000; ++i) {
+    sl.push(i);
+    expected.push_back(i);
+  }
+  // Emptying the list takes the tallest towers first, then new towers grow
+  // back above the ones left.
+  for (int round = 0; round < 3; ++round) {
+    while (sl.size() > 2u) {
+      sl.pop_front();
+      expected.erase(expected.begin());
+    }
+    check_positions(sl, expected);
+    for (int i = 0; i < 500; ++i) {
+      const auto value = 5000 * (round + 1) + i;
+      sl.insert(value);
+      expected.push_back(value);
+    }
+    check_positions(sl, expected);
+    for (auto value : expected) {
+      ASSERT_EQ(*sl.find(value), value);
+    }
+    auto upper = sl.split(expected[expected.size() / 2u]);
+    ASSERT_EQ(*upper.find(expected.back()), expected.back());
+    sl.join(upper);
+    check_positions(sl, expected);
+  }
+}
+
+TEST(Indexing, Percentiles) {
+  indexed_skip_list<int, std::less<int>, DEFAULT_PROBABILITY, 16u> sl;
+  std::vector<int> latencies(100000u);
+  std::mt19937 gen(3);
+  std::uniform_int_distribution<int> latency(0, 1000000);
+  std::generate(latencies.begin(), latencies.end(),
+                [&] { return latency(gen); });
+  sl.insert(latencies.begin(), latencies.end());
+  std::sort(latencies.begin(), latencies.end());
+  for (double percentile : {0.0, 0.5, 0.9, 0.99, 0.999}) {
+    const auto index =
+        static_cast<std::size_t>(percentile *
+                                 static_cast<double>(latencies.size() - 1u));
+    ASSERT_EQ(sl[index], latencies[index]);
+    ASSERT_EQ(*sl.nth(index), latencies[index]);
+    ASSERT_EQ(sl.rank(latencies[index]),
+              static_cast<std::size_t>(
+                  std::lower_bound(latencies.begin(), latencies.end(),
+                                   latencies[index]) -
+                  latencies.begin()));
+  }
+}
+
+TEST(Indexing, SampleIsUniform) {
+  indexed_skip_list<int> sl;
+  for (int i = 0; i < 10; ++i) {
+    sl.push(i);
+  }
+  std::mt19937 gen(8);
+  std::map<int, int> counts;
+  for (int i = 0; i < 10000; ++i) {
+    ++counts[*sl.sample(gen)];
+  }
+  ASSERT_EQ(counts.size(), 10u);
+  for (const auto &[value, count] : counts) {
+    ASSERT_GT(count, 800);
+    ASSERT_LT(count, 1200);
+  }
+  indexed_skip_list<int> empty;
+  ASSERT_EQ(empty.sample(gen), empty.end());
+}
@@ -1,12 +1,111 @@
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <memory>
+#include <numeric>
+#include <stdexcept>
 #include <string>
 #include <type_traits>
+#include <vector>
 
 #include "skip_list.hpp"
+#include "test_helpers.hpp"
 
 using namespace sl;
+using test_helpers::counting_less;
+
+namespace {
+// Throws once `s_budget` more objects have been built.
+struct fragile {
+  fragile() : m_value(0) { acquire(); }
+  explicit fragile(int value) : m_value(value) { acquire(); }
+  fragile(const fragile &other) : m_value(other.m_value) { acquire(); }
+  fragile &operator=(const fragile &) = default;
+  ~fragile() { --s_live; }
+
+  static void acquire() {
+    if (s_budget-- == 0) {
+      throw std::runtime_error("fragile");
+    }
+    ++s_live;
+  }
+
+  bool operator<(const fragile &rhs) const { return m_value < rhs.m_value; }
+
+  int m_value;
+  static inline int s_live{0};
+  static inline int s_budget{-1};
+};
+
+template <typename NodePool>
+using fragile_list =
+    skip_list<fragile, std::less<fragile>, DEFAULT_PROBABILITY,
+              DEFAULT_MAX_NODE_SIZE, test_helpers::counting_allocator<fragile>,
+              geometric_level_generator<DEFAULT_PROBABILITY,
+                                        DEFAULT_MAX_NODE_SIZE>,
+              NodePool>;
+
+// Every constructor that builds elements frees the ones already built
+// when the next one throws.
+template <typename NodePool> void check_constructors_release_nodes() {
+  using list = fragile_list<NodePool>;
+  const std::vector<fragile> sorted{fragile(1), fragile(2), fragile(3),
+                                    fragile(4)};
+  const std::vector<fragile> unsorted{fragile(4), fragile(3), fragile(2),
+                                      fragile(1)};
+  const fragile value(0);
+  const auto live{fragile::s_live};
+  test_helpers::allocation_stats stats;
+  const test_helpers::counting_allocator<fragile> alloc(&stats);
+  fragile::s_budget = 2;
+  ASSERT_THROW(list(sorted.begin(), sorted.end(), alloc), std::runtime_error);
+  fragile::s_budget = 3;
+  ASSERT_THROW(list(unsorted.begin(), unsorted.end(), alloc),
+               std::runtime_error);
+  fragile::s_budget = 2;
+  ASSERT_THROW(list(5u, value, std::less<fragile>{}, alloc),
+               std::runtime_error);
+  // Three value-initialized elements, the fourth one throws.
+  fragile::s_budget = 3;
+  ASSERT_THROW(list(5u, std::less<fragile>{}, alloc), std::runtime_error);
+  fragile::s_budget = -1;
+  ASSERT_EQ(fragile::s_live, live);
+  ASSERT_GT(stats.allocations, 0u);
+  ASSERT_EQ(stats.allocations, stats.deallocations);
+  ASSERT_EQ(stats.live_bytes, 0u);
+}
+
+// A copy that throws halfway frees the part of the clone already built,
+// an assignment that throws leaves a valid list behind.
+template <typename NodePool> void check_copy_releases_nodes() {
+  using list = fragile_list<NodePool>;
+  const auto live{fragile::s_live};
+  test_helpers::allocation_stats stats;
+  {
+    list sl{test_helpers::counting_allocator<fragile>(&stats)};
+    for (int i = 0; i < 100; ++i) {
+      sl.emplace(i);
+    }
+    const auto allocations{stats.allocations};
+    fragile::s_budget = 50;
+    ASSERT_THROW(list{sl}, std::runtime_error);
+    ASSERT_GT(stats.allocations, allocations);
+    list assigned{test_helpers::counting_allocator<fragile>(&stats)};
+    assigned.emplace(-1);
+    fragile::s_budget = 50;
+    ASSERT_THROW(assigned = sl, std::runtime_error);
+    fragile::s_budget = -1;
+    ASSERT_LE(assigned.size(), 50u);
+    ASSERT_TRUE(std::is_sorted(assigned.begin(), assigned.end()));
+    assigned.emplace(100);
+    ASSERT_EQ(assigned.back().m_value, 100);
+    ASSERT_EQ(sl.size(), 100u);
+  }
+  ASSERT_EQ(fragile::s_live, live);
+  ASSERT_EQ(stats.allocations, stats.deallocations);
+  ASSERT_EQ(stats.live_bytes, 0u);
+}
+} // namespace
 
 TEST(Initialization, ClassCreation) {
   ASSERT_NO_THROW(skip_list<int>{});
@@ -86,6 +185,20 @@ TEST(Initialization, ConstructorsSimple) {
   }
 }
 
+TEST(Initialization, ConstructorCountMoveOnly) {
+  // Each element is value-initialized in its own node, none is a copy.
+  skip_list<std::unique_ptr<int>> sl(3u);
+  ASSERT_EQ(sl.size(), 3u);
+  for (const auto &ptr : sl) {
+    ASSERT_EQ(ptr, nullptr);
+  }
+  indexed_skip_list<std::unique_ptr<int>> indexed(5u);
+  ASSERT_EQ(indexed.size(), 5u);
+  ASSERT_EQ(*indexed.nth(4u), nullptr);
+  sl.insert(std::make_unique<int>(1));
+  ASSERT_EQ(sl.size(), 4u);
+}
+
 TEST(Initialization, ConstructorIterators) {
   std::vector<int> v{5, 2, 1, 3, 0, 4};
   skip_list<int> sl_copy_from;
@@ -109,6 +222,63 @@ TEST(Initialization, ConstructorIterators) {
   }
 }
 
+TEST(Initialization, SortedInputIsLinear) {
+  constexpr std::size_t SIZE = 10000u;
+  std::vector<int> sorted(SIZE);
+  std::iota(sorted.begin(), sorted.end(), -100);
+  std::size_t calls = 0u;
+  skip_list<int, counting_less> sl(counting_less{&calls},
+                                   std::allocator<int>{});
+  sl.assign(sorted.begin(), sorted.end());
+  // One comparison with the previous element per element.
+  ASSERT_EQ(calls, SIZE - 1u);
+  ASSERT_EQ(sl.size(), SIZE);
+  ASSERT_TRUE(std::equal(sl.begin(), sl.end(), sorted.begin(), sorted.end()));
+  ASSERT_EQ(sl.front(), -100);
+  ASSERT_EQ(sl.back(), static_cast<int>(SIZE) - 101);
+  for (auto value : sorted) {
+    ASSERT_NE(sl.find(value), sl.end());
+  }
+  ASSERT_EQ(sl.find(-101), sl.end());
+  sl.push(-101);
+  sl.push(5000);
+  sl.push(100000);
+  ASSERT_EQ(sl.size(), SIZE + 3u);
+  ASSERT_EQ(sl.front(), -101);
+  ASSERT_EQ(sl.back(), 100000);
+  ASSERT_TRUE(std::is_sorted(sl.begin(), sl.end()));
+  ASSERT_NE(sl.find(5000), sl.end());
+  ASSERT_NO_THROW(sl.erase(5000));
+  ASSERT_NE(sl.find(5000), sl.end());
+  ASSERT_NO_THROW(sl.erase(5000));
+  ASSERT_EQ(sl.find(5000), sl.end());
+}
+
+TEST(Initialization, PartiallySortedInput) {
+  std::vector<int> values(2000);
+  std::iota(values.begin(), values.begin() + 1000, 0);
+  std::iota(values.begin() + 1000, values.end(), -500);
+  skip_list<int> sl(values.begin(), values.end());
+  std::sort(values.begin(), values.end());
+  ASSERT_EQ(sl.size(), values.size());
+  ASSERT_TRUE(std::equal(sl.begin(), sl.end(), values.begin(), values.end()));
+  for (auto value : values) {
+    ASSERT_NE(sl.find(value), sl.end());
+  }
+  sl = {3, 3, 1, 2};
+  ASSERT_EQ(std::vector<int>(sl.begin(), sl.end()),
+            (std::vector<int>{1, 2, 3, 3}));
+  sl.assign(5u, 7);
+  ASSERT_EQ(sl.size(), 5u);
+  ASSERT_EQ(sl.front(), 7);
+  ASSERT_EQ(sl.back(), 7);
+  ASSERT_EQ(sl.find(7), sl.begin());
+  sl.push(6);
+  sl.push(8);
+  ASSERT_EQ(std::vector<int>(sl.begin(), sl.end()),
+            (std::vector<int>{6, 7, 7, 7, 7, 7, 8}));
+}
+
 TEST(Initialization, ConstructorsCopy) {
   skip_list<int> sl;
   for (int i = -5; i <= 5; ++i) {
@@ -153,6 +323,61 @@ TEST(Initialization, ConstructorsCopy) {
   }
 }
 
+TEST(Initialization, CopyIsLinear) {
+  std::size_t calls = 0u;
+  skip_list<int, counting_less> sl(counting_less{&calls},
+                                   std::allocator<int>{});
+  std::seed_seq seed{21};
+  sl.set_seed(seed);
+  for (int i = 0; i < 1000; ++i) {
+    sl.push((i * 7919) % 1000);
+  }
+  calls = 0u;
+  skip_list<int, counting_less> copy(sl);
+  ASSERT_EQ(calls, 0u);
+  skip_list<int, counting_less> assigned(counting_less{&calls},
+                                         std::allocator<int>{});
+  assigned.push({5, 1, 3});
+  calls = 0u;
+  assigned = sl;
+  ASSERT_EQ(calls, 0u);
+  ASSERT_EQ(copy.size(), sl.size());
+  ASSERT_EQ(assigned.size(), sl.size());
+  ASSERT_TRUE(std::equal(copy.begin(), copy.end(), sl.begin(), sl.end()));
+  ASSERT_TRUE(
+      std::equal(assigned.begin(), assigned.end(), sl.begin(), sl.end()));
+  // Same towers and same random engine, so the same inserts take the same
+  // paths.
+  for (int i = -10; i < 1010; i += 3) {
+    std::size_t visited = 0u;
+    std::size_t copy_visited = 0u;
+    std::size_t assigned_visited = 0u;
+    sl.emplace(i, &visited);
+    copy.emplace(i, &copy_visited);
+    assigned.emplace(i, &assigned_visited);
+    ASSERT_EQ(visited, copy_visited);
+    ASSERT_EQ(visited, assigned_visited);
+  }
+  ASSERT_TRUE(std::equal(copy.begin(), copy.end(), sl.begin(), sl.end()));
+}
+
+TEST(Initialization, CopyNonTrivial) {
+  skip_list<std::string> sl;
+  for (int i = 0; i < 100; ++i) {
+    sl.push(std::string(32u, static_cast<char>('a' + i % 26)));
+  }
+  skip_list<std::string> copy(sl);
+  ASSERT_TRUE(std::equal(copy.begin(), copy.end(), sl.begin(), sl.end()));
+  sl.clear();
+  ASSERT_EQ(copy.size(), 100u);
+  ASSERT_EQ(copy.front(), std::string(32u, 'a'));
+  ASSERT_EQ(copy.back(), std::string(32u, 'z'));
+  sl = copy;
+  ASSERT_EQ(sl.size(), 100u);
+  ASSERT_NE(sl.find(std::string(32u, 'q')), sl.end());
+  ASSERT_NE(&sl.front(), &copy.front());
+}
+
 TEST(Initialization, ConstructorsInitList) {
   skip_list<int> sl{1, -1, 2};
   ASSERT_EQ(sl.front(), -1);
@@ -165,3 +390,13 @@ TEST(Initialization, ConstructorsInitList) {
     ASSERT_EQ(*it, i);
   }
 }
+
+TEST(Initialization, ConstructorsReleaseNodesOnThrow) {
+  check_constructors_release_nodes<no_node_pool>();
+  check_constructors_release_nodes<slab_node_pool<4u>>();
+}
+
+TEST(Initialization, CopyReleasesNodesOnThrow) {
+  check_copy_releases_nodes<no_node_pool>();
+  check_copy_releases_nodes<slab_node_pool<4u>>();
+}
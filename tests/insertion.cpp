@@ -1,13 +1,53 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <iterator>
 #include <random>
+#include <set>
+#include <string>
+#include <utility>
 #include <vector>
 
 #include "skip_list.hpp"
 
 using namespace sl;
 
+namespace {
+// Structure tests below were written against towers drawn uniformly.
+template <typename Compare>
+using uniform_skip_list =
+    skip_list<int, Compare, DEFAULT_PROBABILITY, DEFAULT_MAX_NODE_SIZE,
+              std::allocator<int>,
+              uniform_level_generator<DEFAULT_MAX_NODE_SIZE>>;
+
+// Counts copies, so a rejected duplicate that is copied into a node is caught.
+struct tracked {
+  explicit tracked(int v) : value(v) {}
+  tracked(const tracked &other) : value(other.value) { ++copies; }
+  tracked &operator=(const tracked &) = default;
+  ~tracked() = default;
+  bool operator<(const tracked &rhs) const { return value < rhs.value; }
+
+  int value;
+  static inline int copies = 0;
+};
+
+// Can only be built in place.
+struct pinned {
+  pinned(int k, const char *n) : key(k), name(n) {}
+  pinned(const pinned &) = delete;
+  pinned(pinned &&) = delete;
+  pinned &operator=(const pinned &) = delete;
+  pinned &operator=(pinned &&) = delete;
+  ~pinned() = default;
+  bool operator<(const pinned &rhs) const { return key < rhs.key; }
+
+  int key;
+  std::string name;
+};
+} // namespace
+
 class InsertionPushEmplace
     : public ::testing::TestWithParam<std::function<skip_list<int> &(int)>> {};
 
@@ -119,43 +159,37 @@ TEST_P(InsertionPushEmplace, InsertRandomized_1000) {
 }
 
 TEST(Insertion, VisitedNodesEmplace) {
-  skip_list<int> sl;
+  uniform_skip_list<std::less<int>> sl;
   auto SEED = std::seed_seq({0});
   sl.set_seed(SEED);
-  std::mt19937 gen;
-  gen.seed(SEED);
-  /*                     0
-   * 0                   0
-   * 0       0   X  0   0 0 0
-   * 0 0 0   0   0 0   0 0 0 0
-   * 0 0 0 0 0 0 0 0 0 0 0 0 0
-   * ==========================
-   * 1 0 1 2 3 4 5 6 7 8 9 0 1
+  // Towers once every value is in, X is the second 5. A search moves to a
+  // node, counted as visited, and goes on from the top of its tower.
+  /*                       0
+   * 0                     0
+   * 0       0     X 0   0 0 0
+   * 0 0 0   0   0 X 0   0 0 0 0
+   * 0 0 0 0 0 0 0 X 0 0 0 0 0 0
+   * ===========================
+   * 1 0 1 2 3 4 5 5 6 7 8 9 0 1
    */
-  for (int i = 0; i < 20; ++i) {
-    // Code only to check what size of node is
-    node<int> ng(i, gen);
-    ASSERT_GE(ng.capacity(), 1);
-    // std::cout << i << " = " << ng.size() << '\n';
-  }
   auto emplace = [&](int value) {
     std::size_t visited = 0;
     sl.emplace(value, &visited);
     return visited;
   };
   ASSERT_EQ(emplace(0), 0); // i == 0
-  ASSERT_EQ(emplace(1), 0);
+  ASSERT_EQ(emplace(1), 1);
   ASSERT_EQ(emplace(2), 2);
   ASSERT_EQ(emplace(3), 3);
-  ASSERT_EQ(emplace(4), 3);
-  ASSERT_EQ(emplace(5), 4);
-  ASSERT_EQ(emplace(6), 4);
-  ASSERT_EQ(emplace(7), 4);
-  ASSERT_EQ(emplace(8), 5);
-  ASSERT_EQ(emplace(9), 5);  // i == 9
+  ASSERT_EQ(emplace(4), 1);
+  ASSERT_EQ(emplace(5), 2);
+  ASSERT_EQ(emplace(6), 2);
+  ASSERT_EQ(emplace(7), 2);
+  ASSERT_EQ(emplace(8), 3);
+  ASSERT_EQ(emplace(9), 3);  // i == 9
   ASSERT_EQ(emplace(-1), 0); // i == 10
-  ASSERT_EQ(emplace(10), 2); // i == 11
-  ASSERT_EQ(emplace(11), 3); // i == 12
+  ASSERT_EQ(emplace(10), 1); // i == 11
+  ASSERT_EQ(emplace(11), 2); // i == 12
   ASSERT_EQ(emplace(5), 3);  // i == 13
   auto it = sl.begin();
   for (int i = -1; i <= 5; ++i, ++it) {
@@ -275,11 +309,9 @@ TEST(Insertion, PushMultipleSeeds) {
 
 TEST(Insertion, VisitedNodesReversedEmplace) {
 
-  skip_list<int, std::greater<>> sl;
+  uniform_skip_list<std::greater<>> sl;
   auto SEED = std::seed_seq({123456});
   sl.set_seed(SEED);
-  std::mt19937 gen;
-  gen.seed(SEED);
   /*
    *       0
    *     0 0 0
@@ -288,25 +320,19 @@ TEST(Insertion, VisitedNodesReversedEmplace) {
    * =======================
    * 5 4 3 2 1
    */
-  for (int i = 0; i < 20; ++i) {
-    // Code only to check what size of node is
-    node<int> ng(i, gen);
-    ASSERT_GE(ng.capacity(), 1);
-    // std::cout << i << " = " << ng.size() << '\n';
-  }
   auto emplace = [&](int value) {
     std::size_t visited = 0;
     sl.emplace(value, &visited);
     return visited;
   };
   ASSERT_EQ(emplace(5), 0); // i == 0
-  ASSERT_EQ(emplace(4), 0);
+  ASSERT_EQ(emplace(4), 1);
   ASSERT_EQ(emplace(3), 2);
-  ASSERT_EQ(emplace(2), 2);
-  ASSERT_EQ(emplace(1), 3);
+  ASSERT_EQ(emplace(2), 1);
+  ASSERT_EQ(emplace(1), 1);
   ASSERT_EQ(emplace(10), 0); // i = 5, h = 2
   ASSERT_EQ(emplace(6), 1);  // i = 6, h = 3
-  ASSERT_EQ(emplace(0), 5);  // i = 7, h = 4
+  ASSERT_EQ(emplace(0), 2);  // i = 7, h = 4
   auto it = sl.begin();
   ASSERT_EQ(*(it++), 10);
   for (int i = 6; i >= 0; --i, ++it) {
@@ -371,3 +397,156 @@ TEST(Insertion, InsertWithMoveIterator) {
     ASSERT_EQ(**it, i);
   }
 }
+
+TEST(Insertion, HintedInsertKeepsOrder) {
+  skip_list<int> sl{0, 10, 20, 30};
+  auto it = sl.insert(sl.find(10), 15);
+  ASSERT_EQ(*it, 15);
+  it = sl.emplace_hint(it, 16);
+  ASSERT_EQ(*it, 16);
+  // A hint past the value is ignored.
+  ASSERT_EQ(*sl.insert(sl.find(30), 5), 5);
+  ASSERT_EQ(*sl.insert(sl.end(), 40), 40);
+  ASSERT_EQ(*sl.insert(sl.end(), -5), -5);
+  ASSERT_EQ(*sl.insert(sl.begin(), 25), 25);
+  ASSERT_EQ(std::vector<int>(sl.begin(), sl.end()),
+            (std::vector<int>{-5, 0, 5, 10, 15, 16, 20, 25, 30, 40}));
+  skip_list<int> empty;
+  ASSERT_EQ(*empty.insert(empty.end(), 1), 1);
+  ASSERT_EQ(*empty.insert(empty.begin(), 0), 0);
+  ASSERT_EQ(std::vector<int>(empty.begin(), empty.end()),
+            (std::vector<int>{0, 1}));
+}
+
+TEST(Insertion, HintedInsertBeforeEquivalent) {
+  auto comp = [](const std::pair<int, int> &lhs,
+                 const std::pair<int, int> &rhs) {
+    return lhs.first < rhs.first;
+  };
+  // Hinted or not, a value goes before the elements equivalent to it.
+  skip_list<std::pair<int, int>, decltype(comp)> sl{{0, 0}, {2, 0}};
+  auto it = sl.insert(sl.end(), std::pair{1, 0});
+  for (int i = 1; i < 50; ++i) {
+    it = i % 2 == 0 ? sl.insert(it, std::pair{1, i})
+                    : sl.emplace_hint(sl.begin(), std::pair{1, i});
+  }
+  sl.insert(sl.end(), std::pair{1, 50});
+  sl.emplace(std::pair{1, 51});
+  ASSERT_EQ(sl.size(), 54u);
+  auto expected = 51;
+  for (auto el = std::next(sl.begin()); el->first == 1; ++el) {
+    ASSERT_EQ(el->second, expected--);
+  }
+  ASSERT_EQ(expected, -1);
+  ASSERT_EQ(sl.front(), (std::pair{0, 0}));
+  ASSERT_EQ(sl.back(), (std::pair{2, 0}));
+}
+
+TEST(Insertion, HintedInsertVisitsFewNodes) {
+  skip_list<int, std::less<int>, DEFAULT_PROBABILITY, 16u> sl;
+  auto SEED = std::seed_seq({4});
+  sl.set_seed(SEED);
+  for (int i = 0; i < 20000; i += 2) {
+    sl.insert(sl.end(), i);
+  }
+  ASSERT_EQ(sl.size(), 10000u);
+  std::size_t hinted = 0;
+  std::size_t from_head = 0;
+  for (int i = 1; i < 20000; i += 40) {
+    std::size_t visited = 0;
+    sl.insert(sl.find(i - 1), i, &visited);
+    hinted += visited;
+    sl.insert(i + 2, &visited);
+    from_head += visited;
+  }
+  ASSERT_LT(hinted * 2u, from_head);
+  std::vector<int> sorted(sl.begin(), sl.end());
+  ASSERT_TRUE(std::is_sorted(sorted.begin(), sorted.end()));
+  ASSERT_EQ(sl.size(), 11000u);
+}
+
+TEST(Insertion, HintedInsertRandomized) {
+  skip_list<int> sl;
+  std::multiset<int> expected;
+  std::mt19937 gen(7);
+  std::uniform_int_distribution<int> value(0, 500);
+  auto hint = sl.end();
+  for (int i = 0; i < 5000; ++i) {
+    const auto v = value(gen);
+    expected.insert(v);
+    hint = gen() % 2u == 0u ? sl.insert(hint, v)
+                            : sl.emplace_hint(sl.end(), v);
+  }
+  ASSERT_TRUE(std::equal(sl.begin(), sl.end(), expected.begin(),
+                         expected.end()));
+}
+
+TEST(Insertion, HintedAppendLinksTallTowers) {
+  skip_list<int, std::less<int>, DEFAULT_PROBABILITY, 16u> sl;
+  auto SEED = std::seed_seq({7});
+  sl.set_seed(SEED);
+  for (int i = 0; i < 65536; i += 2) {
+    sl.insert(sl.end(), i);
+  }
+  // Every tower must be linked on all its levels, or searches degrade into
+  // walks along the lower levels.
+  std::size_t visited_max = 0;
+  for (int i = 1; i < 65536; i += 1024) {
+    std::size_t visited = 0;
+    sl.insert(i, &visited);
+    visited_max = std::max(visited_max, visited);
+  }
+  ASSERT_LT(visited_max, 64u);
+  ASSERT_EQ(sl.size(), 32768u + 64u);
+  ASSERT_TRUE(std::is_sorted(sl.begin(), sl.end()));
+}
+
+TEST(Insertion, InsertUnique) {
+  const auto check = [](auto sl) {
+    std::mt19937 gen(11);
+    std::uniform_int_distribution<int> value(0, 300);
+    std::set<int> expected;
+    for (int i = 0; i < 2000; ++i) {
+      const tracked element(value(gen));
+      tracked::copies = 0;
+      const auto [it, inserted] = sl.insert_unique(element);
+      ASSERT_EQ(inserted, expected.insert(element.value).second);
+      ASSERT_EQ(it->value, element.value);
+      ASSERT_EQ(tracked::copies, inserted ? 1 : 0);
+    }
+    ASSERT_EQ(sl.size(), expected.size());
+    ASSERT_TRUE(std::equal(
+        sl.begin(), sl.end(), expected.begin(), expected.end(),
+        [](const tracked &lhs, int rhs) { return lhs.value == rhs; }));
+  };
+  check(skip_list<tracked>{});
+  check(indexed_skip_list<tracked>{});
+  check(bidirectional_skip_list<tracked>{});
+
+  skip_list<int> sl{1, 3, 3};
+  std::vector<int> batch{3, 2, 2, 4, 1};
+  ASSERT_EQ(sl.insert_unique(batch.begin(), batch.end()), 2u);
+  ASSERT_EQ((std::vector<int>(sl.begin(), sl.end())),
+            (std::vector<int>{1, 2, 3, 3, 4}));
+  ASSERT_FALSE(sl.insert_unique(4).second);
+  ASSERT_EQ(*sl.insert_unique(5).first, 5);
+}
+
+TEST(Insertion, EmplaceInPlace) {
+  skip_list<pinned> sl;
+  ASSERT_EQ(sl.emplace(3, "c")->name, "c");
+  ASSERT_EQ(sl.emplace(1, "a")->key, 1);
+  ASSERT_EQ(sl.emplace_hint(sl.end(), 4, "d")->name, "d");
+  ASSERT_EQ(sl.emplace_hint(sl.begin(), 2, "b")->name, "b");
+  std::vector<std::string> names;
+  for (const auto &el : sl) {
+    names.push_back(el.name);
+  }
+  ASSERT_EQ(names, (std::vector<std::string>{"a", "b", "c", "d"}));
+
+  skip_list<std::string> strings;
+  strings.emplace(3u, 'x');
+  strings.emplace("ab", 1u);
+  ASSERT_EQ((std::vector<std::string>(strings.begin(), strings.end())),
+            (std::vector<std::string>{"a", "xxx"}));
+}
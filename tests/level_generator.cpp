@@ -0,0 +1,131 @@
+#include <gtest/gtest.h>
+
+#include "skip_list.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <numeric>
+#include <random>
+#include <vector>
+
+using namespace sl;
+
+namespace {
+constexpr std::size_t DRAWS = 200000u;
+
+template <typename LevelGenerator, std::size_t MaxNodeSize>
+std::array<double, MaxNodeSize + 1u> histogram(unsigned seed) {
+  std::mt19937 gen(seed);
+  LevelGenerator level_generator;
+  std::array<double, MaxNodeSize + 1u> result{};
+  for (std::size_t i = 0u; i < DRAWS; ++i) {
+    const auto level = level_generator(gen);
+    EXPECT_GE(level, 1u);
+    EXPECT_LE(level, MaxNodeSize);
+    result[level] += 1.0 / static_cast<double>(DRAWS);
+  }
+  return result;
+}
+
+template <int ProbabilityInt> void check_geometric(unsigned seed) {
+  constexpr std::size_t MAX_SIZE = 12u;
+  constexpr double p = ProbabilityInt / 100.0;
+  const auto hist =
+      histogram<geometric_level_generator<ProbabilityInt, MAX_SIZE>, MAX_SIZE>(
+          seed);
+  for (std::size_t level = 1u; level < MAX_SIZE; ++level) {
+    const auto expected =
+        std::pow(p, static_cast<double>(level - 1u)) * (1.0 - p);
+    EXPECT_NEAR(hist[level], expected, 0.01) << "Level = " << level;
+  }
+  EXPECT_NEAR(hist[MAX_SIZE], std::pow(p, MAX_SIZE - 1.0), 0.01);
+}
+
+// Average number of nodes visited by the last `probes` inserts of `count`
+// shuffled keys.
+template <std::size_t MaxNodeSize>
+double average_insert_path(std::size_t count, std::size_t probes) {
+  skip_list<int, std::less<int>, DEFAULT_PROBABILITY, MaxNodeSize> sl;
+  std::seed_seq seed{2024};
+  sl.set_seed(seed);
+  std::vector<int> keys(count);
+  std::iota(keys.begin(), keys.end(), 0);
+  std::mt19937 gen(11);
+  std::shuffle(keys.begin(), keys.end(), gen);
+  std::size_t visited_sum = 0u;
+  for (std::size_t i = 0u; i < count; ++i) {
+    std::size_t visited = 0u;
+    sl.emplace(keys[i], &visited);
+    if (i + probes >= count) {
+      visited_sum += visited;
+    }
+  }
+  return static_cast<double>(visited_sum) / static_cast<double>(probes);
+}
+
+struct constant_level_generator {
+  template <typename Generator> std::size_t operator()(Generator &) const {
+    return 2u;
+  }
+};
+} // namespace
+
+TEST(LevelGenerator, GeometricDistribution) {
+  check_geometric<DEFAULT_PROBABILITY>(1u);
+  check_geometric<25>(2u);
+  check_geometric<75>(3u);
+}
+
+TEST(LevelGenerator, GeometricZeroProbability) {
+  const auto hist = histogram<geometric_level_generator<0, 8>, 8>(4u);
+  EXPECT_NEAR(hist[1], 1.0, 1e-6);
+}
+
+TEST(LevelGenerator, GeometricRespectsMaxNodeSize) {
+  const auto hist = histogram<geometric_level_generator<95, 3>, 3>(5u);
+  EXPECT_GT(hist[3], hist[1]);
+  EXPECT_NEAR(hist[1] + hist[2] + hist[3], 1.0, 1e-6);
+}
+
+TEST(LevelGenerator, Uniform) {
+  constexpr std::size_t MAX_SIZE = 5u;
+  const auto hist = histogram<uniform_level_generator<MAX_SIZE>, MAX_SIZE>(6u);
+  for (std::size_t level = 1u; level <= MAX_SIZE; ++level) {
+    EXPECT_NEAR(hist[level], 1.0 / MAX_SIZE, 0.01) << "Level = " << level;
+  }
+}
+
+TEST(LevelGenerator, DefaultIsGeometric) {
+  using list = skip_list<int, std::less<int>, 30, 7>;
+  const auto same_type =
+      std::is_same_v<list::level_generator_type,
+                     geometric_level_generator<30, 7>>;
+  EXPECT_TRUE(same_type);
+}
+
+TEST(LevelGenerator, CustomPolicy) {
+  skip_list<int, std::less<int>, DEFAULT_PROBABILITY, DEFAULT_MAX_NODE_SIZE,
+            std::allocator<int>, constant_level_generator>
+      sl{5, 3, 9, 1, 7};
+  std::vector<int> expected{1, 3, 5, 7, 9};
+  ASSERT_TRUE(std::equal(sl.begin(), sl.end(), expected.begin(),
+                         expected.end()));
+  for (auto v : expected) {
+    ASSERT_NE(sl.find(v), sl.end());
+  }
+  std::size_t visited = 0u;
+  sl.emplace(10, &visited);
+  // Every tower has two levels, so the second level links all nodes.
+  EXPECT_EQ(visited, 5u);
+}
+
+TEST(LevelGenerator, LogarithmicInsertPath) {
+  constexpr std::size_t MAX_SIZE = 16u;
+  constexpr std::size_t PROBES = 1000u;
+  const auto small = average_insert_path<MAX_SIZE>(1u << 10u, PROBES);
+  const auto large = average_insert_path<MAX_SIZE>(1u << 14u, PROBES);
+  EXPECT_LE(small, 3.0 * 10.0);
+  EXPECT_LE(large, 3.0 * 14.0);
+  // 16 times more elements, a linear path would be 16 times longer.
+  EXPECT_LT(large / small, 3.0);
+}
@@ -1,30 +1,95 @@
 #include <gtest/gtest.h>
 
 #include "skip_list.hpp"
+#include "test_helpers.hpp"
+#include <memory>
+#include <string>
 #include <vector>
 
 using namespace sl;
 
+namespace {
+template <typename Node> struct node_deleter {
+  void operator()(Node *node_ptr) const noexcept {
+    std::allocator<typename Node::storage_type> alloc;
+    Node::destroy(alloc, node_ptr);
+  }
+};
+
+template <typename Node>
+using node_ptr = std::unique_ptr<Node, node_deleter<Node>>;
+
+// Allocates the storage and builds the node in it, as the list does.
+template <typename Node, typename Allocator, typename... Args>
+Node *create_node(Allocator &alloc, std::size_t capacity, Args &&...args) {
+  using traits = std::allocator_traits<Allocator>;
+  const auto units = Node::storage_size(capacity);
+  auto *storage = traits::allocate(alloc, units);
+  try {
+    return Node::construct(alloc, storage, capacity,
+                           std::forward<Args>(args)...);
+  } catch (...) {
+    traits::deallocate(alloc, storage, units);
+    throw;
+  }
+}
+
+template <typename Node, typename... Args>
+node_ptr<Node> make_node(std::size_t capacity, Args &&...args) {
+  std::allocator<typename Node::storage_type> alloc;
+  return node_ptr<Node>(
+      create_node<Node>(alloc, capacity, std::forward<Args>(args)...));
+}
+
+template <typename Node>
+std::vector<node_ptr<Node>>
+make_nodes(const std::vector<std::size_t> &capacities) {
+  std::vector<node_ptr<Node>> nodes;
+  int value = 0;
+  for (auto capacity : capacities) {
+    nodes.emplace_back(make_node<Node>(capacity, value++));
+  }
+  return nodes;
+}
+} // namespace
+
 TEST(Node, Constructor) {
-  std::mt19937 gen(0);
-  ASSERT_NO_THROW(node<int>(5, gen));
+  ASSERT_NO_THROW(make_node<node<int>>(1, 5));
   constexpr std::size_t MAX_SIZE = 10u;
-  node<int, MAX_SIZE> nd(12, gen);
-  ASSERT_EQ(nd.capacity(), 6);
-  ASSERT_LE(nd.capacity(), MAX_SIZE);
-  ASSERT_EQ(nd.get(), 12);
-  for (std::size_t i = 0u; i < MAX_SIZE; ++i) {
-    ASSERT_EQ(nd.get_next(i), nullptr);
+  auto nd = make_node<node<int, MAX_SIZE>>(6, 12);
+  ASSERT_EQ(nd->capacity(), 6);
+  ASSERT_LE(nd->capacity(), MAX_SIZE);
+  ASSERT_EQ(nd->get(), 12);
+  for (std::size_t i = 0u; i < nd->capacity(); ++i) {
+    ASSERT_EQ(nd->get_next(i), nullptr);
+  }
+  nd->get() = 5;
+  ASSERT_EQ(nd->get(), 5);
+  auto str = make_node<node<std::string>>(2, 3, 'a');
+  ASSERT_EQ(str->get(), "aaa");
+  ASSERT_EQ(str->capacity(), 2);
+}
+
+TEST(Node, Layout) {
+  using node_type = node<int, 16>;
+  static_assert(sizeof(node_type::level_type) == 1u);
+  static_assert(alignof(node_type) >= alignof(node_type *));
+  static_assert(sizeof(node_type) <= sizeof(int) + alignof(node_type *));
+  for (std::size_t capacity = 1u; capacity <= 16u; ++capacity) {
+    test_helpers::allocation_stats stats;
+    test_helpers::counting_allocator<node_type::storage_type> alloc(&stats);
+    auto nd = create_node<node_type>(alloc, capacity, 1);
+    ASSERT_EQ(stats.live_bytes,
+              sizeof(node_type) + capacity * sizeof(node_type *));
+    node_type::destroy(alloc, nd);
+    ASSERT_EQ(stats.live_bytes, 0u);
   }
-  nd.get() = 5;
-  ASSERT_EQ(nd.get(), 5);
 }
 
 TEST(Node, clear_nexts) {
-  constexpr int SEED = 1;
-  std::mt19937 gen(SEED);
-  node<int> nd0(1, gen);
-  node<int> nd1(2, gen);
+  auto nodes = make_nodes<node<int>>({3, 5});
+  auto &nd0 = *nodes[0];
+  auto &nd1 = *nodes[1];
   for (std::size_t i = 0u; i < nd0.capacity(); ++i) {
     ASSERT_EQ(nd0.get_next(i), nullptr);
     nd0.get_next(i) = &nd1;
@@ -37,11 +102,10 @@ TEST(Node, clear_nexts) {
 }
 
 TEST(Node, rbegin_rend) {
-  constexpr int SEED = 1;
   constexpr std::size_t MAX_SIZE = 5u;
-  std::mt19937 gen(SEED);
-  node<int, MAX_SIZE> nd0(1, gen);
-  node<int, MAX_SIZE> nd1(2, gen);
+  auto nodes = make_nodes<node<int, MAX_SIZE>>({3, 5});
+  auto &nd0 = *nodes[0];
+  auto &nd1 = *nodes[1];
   ASSERT_EQ(nd0.capacity(), 3);
   nd0.get_next(0) = &nd1;
   nd0.get_next(1) = &nd1;
@@ -53,161 +117,3 @@ TEST(Node, rbegin_rend) {
   }
   ASSERT_EQ(count_iterations, nd0.capacity());
 }
-
-TEST(Node, fill_nexts_insert_third) {
-  constexpr int SEED = 1;
-  std::mt19937 gen(SEED);
-  node<int> nd0(1, gen);
-  node<int> nd1(2, gen);
-  ASSERT_EQ(nd0.get(), 1);
-  ASSERT_EQ(nd1.get(), 2);
-  ASSERT_GT(nd0.capacity(), 2);
-  ASSERT_GT(nd1.capacity(), 2);
-  for (std::size_t i = 0u; i < nd0.capacity(); ++i) {
-    nd0.get_next(i) = &nd1;
-  }
-  node<int> nd2(3, gen);
-  ASSERT_GT(nd2.capacity(), 2);
-  nd2.get_next(0) = &nd0;
-  ASSERT_NO_THROW(nd2.fill_nexts());
-}
-
-TEST(Node, fill_nexts_1) {
-  constexpr int SEED = 1;
-  std::mt19937 gen(SEED);
-  node<int> nd(1, gen);
-  ASSERT_EQ(nd.get(), 1);
-  ASSERT_GT(nd.capacity(), 2);
-  nd.get_next(0) = &nd;
-  ASSERT_EQ(&nd, nd.get_next(0));
-  ASSERT_NO_THROW(nd.fill_nexts());
-  for (std::size_t i = 0u; i < nd.capacity(); ++i) {
-    ASSERT_EQ(&nd, nd.get_next(i));
-  }
-}
-
-TEST(Node, fill_nexts_5) {
-  constexpr int SEED = 1;
-  constexpr std::size_t SIZE = 5;
-  ASSERT_GE(SIZE, 2u);
-  std::mt19937 gen(SEED);
-  std::vector<node<int>> nodes;
-  for (std::size_t i = 0u; i < SIZE; ++i) {
-    ASSERT_NO_THROW(nodes.emplace_back(i, gen));
-    ASSERT_EQ(nodes.back().get(), i);
-    ASSERT_GT(nodes.back().capacity(), 0);
-  }
-  /*
-   *   0---0
-   *   0-0-0
-   * 0-0-0-0
-   * 0-0-0-0
-   * 0-0-0-0-0
-   */
-  for (std::size_t i = 0u; i < SIZE - 1u; ++i) {
-    nodes[i].get_next(0) = &nodes[i + 1u];
-  }
-  for (std::size_t i = 0u; i < SIZE; ++i) {
-    ASSERT_NO_THROW(nodes[i].fill_nexts());
-  }
-
-  // Check for first node
-  ASSERT_EQ(nodes[0].get_next(2), &nodes[1]);
-  ASSERT_EQ(nodes[0].get_next(1), &nodes[1]);
-  ASSERT_EQ(nodes[0].get_next(0), &nodes[1]);
-
-  // Check for second node
-  ASSERT_EQ(nodes[1].get_next(0), &nodes[2]);
-  ASSERT_EQ(nodes[1].get_next(1), &nodes[2]);
-  ASSERT_EQ(nodes[1].get_next(2), &nodes[2]);
-  ASSERT_EQ(nodes[1].get_next(3), &nodes[2]);
-  ASSERT_EQ(nodes[1].get_next(4), &nodes[3]);
-
-  // Check for third node
-  ASSERT_EQ(nodes[2].get_next(0), &nodes[3]);
-  ASSERT_EQ(nodes[2].get_next(1), &nodes[3]);
-  ASSERT_EQ(nodes[2].get_next(2), &nodes[3]);
-  ASSERT_EQ(nodes[2].get_next(3), &nodes[3]);
-
-  // Check for fourth node
-  ASSERT_EQ(nodes[3].get_next(0), &nodes[4]);
-  ASSERT_EQ(nodes[3].get_next(1), nullptr);
-  ASSERT_EQ(nodes[3].get_next(2), nullptr);
-  ASSERT_EQ(nodes[3].get_next(3), nullptr);
-  ASSERT_EQ(nodes[3].get_next(4), nullptr);
-}
-
-TEST(Node, fill_nexts_10) {
-  constexpr int SEED = 2;
-  constexpr std::size_t SIZE = 10;
-  ASSERT_GE(SIZE, 2u);
-  std::mt19937 gen(SEED);
-  std::vector<node<int>> nodes;
-  for (std::size_t i = 0u; i < SIZE; ++i) {
-    ASSERT_NO_THROW(nodes.emplace_back(i, gen));
-    ASSERT_EQ(nodes.back().get(), i);
-    ASSERT_GT(nodes.back().capacity(), 0);
-  }
-  /*
-   *       0   0
-   *       0   0
-   * 0     0 0 0 0 0 0
-   * 0     0 0 0 0 0 0 0
-   * 0 0 0 0 0 0 0 0 0 0
-   */
-  for (std::size_t i = 0u; i < SIZE - 1u; ++i) {
-    nodes[i].get_next(0) = &nodes[i + 1u];
-  }
-  for (std::size_t i = 0u; i < SIZE; ++i) {
-    ASSERT_NO_THROW(nodes[i].fill_nexts());
-  }
-
-  // Check for 1 node
-  ASSERT_EQ(nodes[0].get_next(2), &nodes[3]);
-  ASSERT_EQ(nodes[0].get_next(1), &nodes[3]);
-  ASSERT_EQ(nodes[0].get_next(0), &nodes[1]);
-
-  // Check for 2 node
-  ASSERT_EQ(nodes[1].get_next(0), &nodes[2]);
-
-  // Check for 3 node
-  ASSERT_EQ(nodes[2].get_next(0), &nodes[3]);
-
-  // Check for 4 node
-  ASSERT_EQ(nodes[3].get_next(0), &nodes[4]);
-  ASSERT_EQ(nodes[3].get_next(1), &nodes[4]);
-  ASSERT_EQ(nodes[3].get_next(2), &nodes[4]);
-  ASSERT_EQ(nodes[3].get_next(3), &nodes[5]);
-  ASSERT_EQ(nodes[3].get_next(4), &nodes[5]);
-
-  // Check for 5 node
-  ASSERT_EQ(nodes[4].get_next(0), &nodes[5]);
-  ASSERT_EQ(nodes[4].get_next(1), &nodes[5]);
-  ASSERT_EQ(nodes[4].get_next(2), &nodes[5]);
-
-  // Check for 6 node
-  ASSERT_EQ(nodes[5].get_next(0), &nodes[6]);
-  ASSERT_EQ(nodes[5].get_next(1), &nodes[6]);
-  ASSERT_EQ(nodes[5].get_next(2), &nodes[6]);
-  ASSERT_EQ(nodes[5].get_next(3), nullptr);
-  ASSERT_EQ(nodes[5].get_next(4), nullptr);
-
-  // Check for 7 node
-  ASSERT_EQ(nodes[6].get_next(0), &nodes[7]);
-  ASSERT_EQ(nodes[6].get_next(1), &nodes[7]);
-  ASSERT_EQ(nodes[6].get_next(2), &nodes[7]);
-
-  // Check for 8 node
-  ASSERT_EQ(nodes[7].get_next(0), &nodes[8]);
-  ASSERT_EQ(nodes[7].get_next(1), &nodes[8]);
-  ASSERT_EQ(nodes[7].get_next(2), &nodes[8]);
-
-  // Check for 9 node
-  ASSERT_EQ(nodes[8].get_next(0), &nodes[9]);
-  ASSERT_EQ(nodes[8].get_next(1), &nodes[9]);
-  ASSERT_EQ(nodes[8].get_next(2), nullptr);
-
-  // Check for 10 node
-  ASSERT_EQ(nodes[9].get_next(0), nullptr);
-  ASSERT_EQ(nodes[9].get_next(1), nullptr);
-}
@@ -0,0 +1,103 @@
+#include <gtest/gtest.h>
+
+#include "skip_list.hpp"
+#include "test_helpers.hpp"
+#include <algorithm>
+#include <iterator>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace sl;
+using test_helpers::allocation_stats;
+using test_helpers::counting_allocator;
+
+namespace {
+template <typename SkipList>
+std::vector<typename SkipList::value_type> values(const SkipList &sl) {
+  return {sl.begin(), sl.end()};
+}
+
+template <bool Indexed, bool Bidirectional> void check_move_between_lists() {
+  using SkipList = test_helpers::layout_list<int, Indexed, Bidirectional,
+                                             std::less<int>,
+                                             counting_allocator<int>>;
+  using allocator = counting_allocator<int>;
+  allocation_stats stats;
+  SkipList pending(std::less<int>{}, allocator(&stats));
+  SkipList active(std::less<int>{}, allocator(&stats));
+  for (int i = 0; i < 100; ++i) {
+    pending.insert(i % 50);
+  }
+  const auto allocations = stats.allocations;
+  for (int i = 0; i < 50; i += 2) {
+    auto handle = pending.extract_node(i);
+    ASSERT_FALSE(handle.empty());
+    ASSERT_EQ(handle.value(), i);
+    ASSERT_EQ(*active.insert(std::move(handle)), i);
+    ASSERT_TRUE(handle.empty());
+  }
+  // Moving to the front of the book and back, by position.
+  for (int i = 0; i < 10; ++i) {
+    auto last = std::next(active.begin(),
+                          static_cast<long>(active.size()) - 1);
+    auto handle = active.extract_node(last);
+    handle.value() = -i;
+    pending.insert(pending.begin(), std::move(handle));
+  }
+  ASSERT_EQ(stats.allocations, allocations);
+  ASSERT_EQ(stats.deallocations, 0u);
+  ASSERT_EQ(pending.size(), 85u);
+  ASSERT_EQ(active.size(), 15u);
+  ASSERT_TRUE(std::is_sorted(pending.begin(), pending.end()));
+  ASSERT_EQ(values(active).back(), 28);
+  for (int i = 0; i < 50; ++i) {
+    ASSERT_NE(pending.find(i), pending.end());
+    ASSERT_EQ(active.find(i) != active.end(), i % 2 == 0 && i < 30);
+  }
+  ASSERT_EQ(pending.front(), -9);
+}
+} // namespace
+
+TEST(NodeHandle, MovesWithoutAllocating) {
+  test_helpers::for_each_layout([]<bool Indexed, bool Bidirectional>() {
+    check_move_between_lists<Indexed, Bidirectional>();
+  });
+}
+
+TEST(NodeHandle, RanksFollowMovedNodes) {
+  indexed_skip_list<int> lhs{1, 3, 5, 7, 9};
+  indexed_skip_list<int> rhs{2, 4, 6};
+  rhs.insert(lhs.extract_node(5));
+  ASSERT_EQ(rhs.rank(6), 3u);
+  ASSERT_EQ(rhs[2], 5);
+  ASSERT_EQ(lhs[2], 7);
+  ASSERT_EQ(lhs.index_of(lhs.find(9)), 3u);
+}
+
+TEST(NodeHandle, EmptyAndDropped) {
+  allocation_stats stats;
+  skip_list<std::string, std::less<std::string>, DEFAULT_PROBABILITY,
+            DEFAULT_MAX_NODE_SIZE, counting_allocator<std::string>>
+      sl(std::less<std::string>{}, counting_allocator<std::string>(&stats));
+  sl.insert(std::string("a"));
+  sl.insert(std::string("b"));
+  auto missing = sl.extract_node(std::string("c"));
+  ASSERT_TRUE(missing.empty());
+  ASSERT_FALSE(missing);
+  ASSERT_EQ(sl.insert(std::move(missing)), sl.end());
+  ASSERT_TRUE(sl.extract_node(sl.end()).empty());
+  {
+    auto dropped = sl.extract_node(std::string("a"));
+    ASSERT_TRUE(dropped);
+    ASSERT_EQ(dropped.get_allocator(), sl.get_allocator());
+    decltype(dropped) other;
+    swap(dropped, other);
+    ASSERT_TRUE(dropped.empty());
+    ASSERT_EQ(other.value(), "a");
+    ASSERT_EQ(stats.deallocations, 0u);
+  }
+  // A handle that is never inserted frees its node.
+  ASSERT_EQ(stats.deallocations, 1u);
+  ASSERT_EQ(values(sl), (std::vector<std::string>{"b"}));
+}
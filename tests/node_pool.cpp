@@ -0,0 +1,268 @@
+#include <gtest/gtest.h>
+
+#include "skip_list.hpp"
+#include "test_helpers.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+using namespace sl;
+using test_helpers::allocation_stats;
+using test_helpers::counting_allocator;
+
+namespace {
+template <typename T, std::size_t NodesPerSlab = 64u>
+using pooled_list =
+    skip_list<T, std::less<T>, DEFAULT_PROBABILITY, 8u, counting_allocator<T>,
+              geometric_level_generator<DEFAULT_PROBABILITY, 8u>,
+              slab_node_pool<NodesPerSlab>>;
+
+template <typename T>
+using pooled_list_std =
+    skip_list<T, std::less<T>, DEFAULT_PROBABILITY, 8u, std::allocator<T>,
+              geometric_level_generator<DEFAULT_PROBABILITY, 8u>,
+              slab_node_pool<16u>>;
+
+template <typename SkipList>
+void push_range(SkipList &sl, int first, int last) {
+  for (int i = first; i < last; ++i) {
+    ASSERT_NO_THROW(sl.push(i));
+  }
+}
+} // namespace
+
+TEST(NodePool, FewerAllocationsThanNodes) {
+  allocation_stats stats;
+  {
+    pooled_list<int> sl{counting_allocator<int>(&stats)};
+    push_range(sl, 0, 1000);
+    ASSERT_EQ(sl.size(), 1000u);
+    // One slab per 64 nodes of a height, at most one partial slab per height.
+    ASSERT_LE(stats.allocations, 1000u / 64u + 8u);
+    ASSERT_TRUE(std::is_sorted(sl.begin(), sl.end()));
+  }
+  ASSERT_EQ(stats.live_bytes, 0u);
+}
+
+TEST(NodePool, ErasedNodesAreRecycled) {
+  allocation_stats stats;
+  pooled_list<int, 4u> sl{counting_allocator<int>(&stats)};
+  push_range(sl, 0, 200);
+  const auto allocations = stats.allocations;
+  for (int round = 0; round < 10; ++round) {
+    for (int i = 0; i < 200; ++i) {
+      const auto extracted = sl.extract(i);
+      ASSERT_TRUE(extracted.has_value());
+      ASSERT_NO_THROW(sl.push(i));
+    }
+  }
+  // A new slab is only needed when no node of the drawn height was freed,
+  // without the pool every push would allocate.
+  ASSERT_LT(stats.allocations - allocations, 2000u / 4u);
+  ASSERT_EQ(sl.size(), 200u);
+  ASSERT_TRUE(std::is_sorted(sl.begin(), sl.end()));
+}
+
+TEST(NodePool, ReserveAvoidsAllocations) {
+  allocation_stats stats;
+  pooled_list<int> sl{counting_allocator<int>(&stats)};
+  std::seed_seq seed{17};
+  sl.set_seed(seed);
+  ASSERT_NO_THROW(sl.reserve(5000u));
+  const auto allocations = stats.allocations;
+  ASSERT_GT(allocations, 0u);
+  push_range(sl, 0, 5000);
+  ASSERT_EQ(stats.allocations, allocations);
+  ASSERT_NO_THROW(sl.reserve(0u));
+  ASSERT_EQ(stats.allocations, allocations);
+}
+
+TEST(NodePool, ReserveCountsSpareSlabs) {
+  allocation_stats stats;
+  // Towers of one level share one set of slabs of eight nodes.
+  skip_list<int, std::less<int>, DEFAULT_PROBABILITY, 8u,
+            counting_allocator<int>, uniform_level_generator<1u>,
+            slab_node_pool<8u>>
+      sl{counting_allocator<int>(&stats)};
+  ASSERT_NO_THROW(sl.reserve(20u));
+  ASSERT_EQ(stats.allocations, 3u);
+  // The three spare slabs hold 24 nodes, two more make room for 40.
+  ASSERT_NO_THROW(sl.reserve(40u));
+  ASSERT_EQ(stats.allocations, 5u);
+  ASSERT_NO_THROW(sl.reserve(40u));
+  ASSERT_EQ(stats.allocations, 5u);
+  push_range(sl, 0, 36);
+  ASSERT_EQ(stats.allocations, 5u);
+  // Four nodes are left in the used slab, one more slab holds the rest.
+  ASSERT_NO_THROW(sl.reserve(48u - 36u));
+  ASSERT_EQ(stats.allocations, 6u);
+  push_range(sl, 36, 48);
+  ASSERT_EQ(stats.allocations, 6u);
+  ASSERT_EQ(stats.deallocations, 0u);
+}
+
+TEST(NodePool, ClearKeepsSlabs) {
+  allocation_stats stats;
+  pooled_list<int> sl{counting_allocator<int>(&stats)};
+  std::seed_seq seed{3};
+  sl.set_seed(seed);
+  push_range(sl, 0, 3000);
+  const auto allocations = stats.allocations;
+  const auto live_bytes = stats.live_bytes;
+  ASSERT_NO_THROW(sl.clear());
+  ASSERT_TRUE(sl.empty());
+  ASSERT_EQ(sl.begin(), sl.end());
+  ASSERT_EQ(stats.live_bytes, live_bytes);
+  std::seed_seq same_seed{3};
+  sl.set_seed(same_seed);
+  push_range(sl, 0, 3000);
+  ASSERT_EQ(stats.allocations, allocations);
+  ASSERT_EQ(sl.size(), 3000u);
+  ASSERT_TRUE(std::is_sorted(sl.begin(), sl.end()));
+  ASSERT_NO_THROW(sl.clear());
+  ASSERT_NO_THROW(sl.shrink_to_fit());
+  ASSERT_EQ(stats.live_bytes, 0u);
+}
+
+TEST(NodePool, ClearDestroysValues) {
+  allocation_stats stats;
+  pooled_list<std::string> sl{counting_allocator<std::string>(&stats)};
+  for (int i = 0; i < 100; ++i) {
+    sl.push(std::string(64u, static_cast<char>('a' + i % 26)));
+  }
+  ASSERT_NO_THROW(sl.clear());
+  ASSERT_TRUE(sl.empty());
+  sl.push(std::string(64u, 'z'));
+  ASSERT_EQ(sl.front(), std::string(64u, 'z'));
+}
+
+TEST(NodePool, ShrinkToFit) {
+  allocation_stats stats;
+  // Towers of one level share one set of slabs, filled in insertion order.
+  skip_list<int, std::less<int>, DEFAULT_PROBABILITY, 8u,
+            counting_allocator<int>, uniform_level_generator<1u>,
+            slab_node_pool<8u>>
+      sl{counting_allocator<int>(&stats)};
+  push_range(sl, 0, 2000);
+  ASSERT_EQ(stats.allocations, 250u);
+  const auto full_bytes = stats.live_bytes;
+  const auto slab_bytes = full_bytes / 250u;
+  // Every other node of a slab still leaves it in use.
+  for (int i = 1000; i < 2000; i += 2) {
+    ASSERT_NO_THROW(sl.erase(i));
+  }
+  ASSERT_NO_THROW(sl.shrink_to_fit());
+  ASSERT_EQ(stats.live_bytes, full_bytes);
+  // The first thousand nodes fill 125 slabs, which are all given back.
+  for (int i = 0; i < 1000; ++i) {
+    ASSERT_NO_THROW(sl.erase(i));
+  }
+  ASSERT_EQ(stats.live_bytes, full_bytes);
+  ASSERT_NO_THROW(sl.shrink_to_fit());
+  ASSERT_EQ(stats.live_bytes, full_bytes - 125u * slab_bytes);
+  ASSERT_EQ(stats.deallocations, 125u);
+  ASSERT_EQ(sl.size(), 500u);
+  int expected = 1001;
+  for (auto value : sl) {
+    ASSERT_EQ(value, expected);
+    expected += 2;
+  }
+  for (int i = 1001; i < 2000; i += 2) {
+    ASSERT_NO_THROW(sl.erase(i));
+  }
+  ASSERT_TRUE(sl.empty());
+  ASSERT_NO_THROW(sl.shrink_to_fit());
+  ASSERT_EQ(stats.live_bytes, 0u);
+  push_range(sl, 0, 100);
+  ASSERT_EQ(sl.size(), 100u);
+  ASSERT_TRUE(std::is_sorted(sl.begin(), sl.end()));
+}
+
+TEST(NodePool, MoveAndSwap) {
+  pooled_list_std<std::string> lhs{"b", "d", "f"};
+  pooled_list_std<std::string> rhs{"a", "c"};
+  swap(lhs, rhs);
+  ASSERT_EQ(lhs.size(), 2u);
+  ASSERT_EQ(rhs.size(), 3u);
+  lhs.push("e");
+  rhs.erase("d");
+  pooled_list_std<std::string> moved(std::move(lhs));
+  ASSERT_TRUE(lhs.empty());
+  moved.erase("a");
+  rhs = std::move(moved);
+  ASSERT_EQ(std::vector<std::string>(rhs.begin(), rhs.end()),
+            (std::vector<std::string>{"c", "e"}));
+  pooled_list_std<std::string> copy(rhs);
+  copy.push("g");
+  ASSERT_EQ(copy.size(), 3u);
+  ASSERT_EQ(rhs.size(), 2u);
+}
+
+TEST(NodePool, MoveOutlivesSource) {
+  pooled_list_std<std::string> kept;
+  {
+    pooled_list_std<std::string> source{"a", "b", "c"};
+    pooled_list_std<std::string> moved(std::move(source));
+    swap(kept, moved);
+  }
+  // The slabs went with the nodes, not with the destroyed lists.
+  kept.push("d");
+  ASSERT_EQ(std::vector<std::string>(kept.begin(), kept.end()),
+            (std::vector<std::string>{"a", "b", "c", "d"}));
+}
+
+TEST(NodePool, MergeAdoptsNodes) {
+  allocation_stats stats;
+  pooled_list<int, 8u> sl{counting_allocator<int>(&stats)};
+  push_range(sl, 0, 100);
+  {
+    pooled_list<int, 8u> other{counting_allocator<int>(&stats)};
+    push_range(other, 50, 300);
+    other.erase(60);
+    ASSERT_NO_THROW(sl.merge(other));
+    ASSERT_TRUE(other.empty());
+  }
+  ASSERT_EQ(sl.size(), 349u);
+  ASSERT_TRUE(std::is_sorted(sl.begin(), sl.end()));
+  const auto allocations = stats.allocations;
+  // The free node of the merged list is reused.
+  sl.push(60);
+  sl.erase(0);
+  sl.push(0);
+  ASSERT_EQ(sl.size(), 350u);
+  ASSERT_TRUE(std::is_sorted(sl.begin(), sl.end()));
+  ASSERT_LE(stats.allocations, allocations + 1u);
+  ASSERT_NO_THROW(sl.clear());
+  ASSERT_NO_THROW(sl.shrink_to_fit());
+  ASSERT_EQ(stats.live_bytes, 0u);
+}
+
+TEST(NodePool, RandomizedChurn) {
+  pooled_list_std<int> sl;
+  std::multiset<int> expected;
+  std::mt19937 gen(99);
+  std::uniform_int_distribution<int> value(0, 300);
+  for (int i = 0; i < 20000; ++i) {
+    const auto v = value(gen);
+    if (gen() % 3u == 0u) {
+      const auto found = expected.find(v);
+      if (found != expected.end()) {
+        expected.erase(found);
+      }
+      sl.erase(v);
+    } else {
+      expected.insert(v);
+      sl.push(v);
+    }
+    if (i % 5000 == 0) {
+      sl.shrink_to_fit();
+    }
+  }
+  ASSERT_EQ(sl.size(), expected.size());
+  ASSERT_TRUE(std::equal(sl.begin(), sl.end(), expected.begin(),
+                         expected.end()));
+}
@@ -1,11 +1,19 @@
 #include <gtest/gtest.h>
 
 #include "skip_list.hpp"
+#include "test_helpers.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
 #include <memory>
-#include <random>
+#include <stdexcept>
 #include <string>
+#include <utility>
+#include <vector>
 
 using namespace sl;
+using test_helpers::random_values;
 
 TEST(Operations, Merge) {
   skip_list<int> sl1{1, 2, 3, 4};
@@ -60,6 +68,245 @@ TEST(Operations, MergeStringsUniquePtr) {
   ASSERT_EQ(it, sl2.end());
 }
 
+namespace {
+struct first_less {
+  bool operator()(const std::pair<int, int> &lhs,
+                  const std::pair<int, int> &rhs) const {
+    return lhs.first < rhs.first;
+  }
+};
+
+using pair_list = skip_list<std::pair<int, int>, first_less>;
+
+// Merges `other_keys` (tagged 1) into `keys` (tagged 0) and checks that no
+// element was copied and that equivalent elements of the target come first.
+void check_merge(const std::vector<int> &keys,
+                 const std::vector<int> &other_keys) {
+  pair_list sl;
+  pair_list other;
+  for (auto key : keys) {
+    sl.push(std::make_pair(key, 0));
+  }
+  for (auto key : other_keys) {
+    other.push(std::make_pair(key, 1));
+  }
+  std::vector<const std::pair<int, int> *> addresses;
+  for (const auto &value : sl) {
+    addresses.push_back(&value);
+  }
+  for (const auto &value : other) {
+    addresses.push_back(&value);
+  }
+  ASSERT_NO_THROW(sl.merge(other));
+  ASSERT_TRUE(other.empty());
+  ASSERT_EQ(other.begin(), other.end());
+  ASSERT_EQ(sl.size(), keys.size() + other_keys.size());
+  std::vector<std::pair<int, int>> expected;
+  for (auto key : keys) {
+    expected.emplace_back(key, 0);
+  }
+  for (auto key : other_keys) {
+    expected.emplace_back(key, 1);
+  }
+  std::stable_sort(expected.begin(), expected.end(), first_less{});
+  ASSERT_TRUE(std::equal(sl.begin(), sl.end(), expected.begin(),
+                         expected.end()));
+  std::vector<const std::pair<int, int> *> merged_addresses;
+  for (const auto &value : sl) {
+    merged_addresses.push_back(&value);
+  }
+  std::sort(addresses.begin(), addresses.end());
+  std::sort(merged_addresses.begin(), merged_addresses.end());
+  ASSERT_EQ(addresses, merged_addresses);
+  for (std::size_t i = 0u; i < expected.size(); ++i) {
+    // Only the first of equivalent elements can be found by value.
+    if (i == 0u || expected[i - 1u].first != expected[i].first) {
+      ASSERT_NE(sl.find(expected[i]), sl.end());
+    }
+  }
+  ASSERT_EQ(sl.front(), expected.front());
+  ASSERT_EQ(sl.back(), expected.back());
+  sl.push(std::make_pair(expected.back().first + 1, 2));
+  ASSERT_EQ(sl.back().second, 2);
+  // The merged list and the emptied one are still usable.
+  other.push(std::make_pair(1, 1));
+  ASSERT_EQ(other.size(), 1u);
+}
+
+template <typename SkipList>
+void check_part(const SkipList &sl, const std::vector<int> &expected) {
+  ASSERT_EQ(sl.size(), expected.size());
+  ASSERT_TRUE(
+      std::equal(sl.begin(), sl.end(), expected.begin(), expected.end()));
+  for (auto key : expected) {
+    ASSERT_NE(sl.find(key), sl.end());
+  }
+  if (!expected.empty()) {
+    ASSERT_EQ(sl.front(), expected.front());
+    ASSERT_EQ(sl.back(), expected.back());
+  }
+  if constexpr (requires { sl.nth(0u); }) {
+    for (std::size_t i = 0u; i < expected.size(); ++i) {
+      ASSERT_EQ(*sl.nth(i), expected[i]);
+    }
+  }
+}
+
+// Splits `keys` at `key`, joins the parts back and checks the three lists.
+template <typename SkipList>
+void check_split_join(std::vector<int> keys, int key) {
+  SkipList sl(keys.begin(), keys.end());
+  std::sort(keys.begin(), keys.end());
+  const auto middle = std::lower_bound(keys.begin(), keys.end(), key);
+  const std::vector<int> prefix(keys.begin(), middle);
+  const std::vector<int> suffix(middle, keys.end());
+  auto other = sl.split(key);
+  check_part(sl, prefix);
+  check_part(other, suffix);
+  sl.join(other);
+  ASSERT_TRUE(other.empty());
+  check_part(sl, keys);
+  // Both lists are still usable.
+  sl.push(-1);
+  other.push(1);
+  ASSERT_EQ(sl.front(), -1);
+  ASSERT_EQ(other.size(), 1u);
+}
+
+// Throws from its move constructor once `s_budget` more moves are made.
+struct fragile_move {
+  explicit fragile_move(int value) : m_value(value) {}
+  fragile_move(const fragile_move &) = default;
+  fragile_move(fragile_move &&other) : m_value(other.m_value) {
+    if (s_budget-- == 0) {
+      throw std::runtime_error("fragile_move");
+    }
+  }
+  fragile_move &operator=(const fragile_move &) = default;
+  fragile_move &operator=(fragile_move &&) = default;
+  ~fragile_move() = default;
+
+  bool operator<(const fragile_move &rhs) const {
+    return m_value < rhs.m_value;
+  }
+
+  int m_value;
+  static inline int s_budget{-1};
+};
+
+template <typename NodePool>
+using fragile_move_list =
+    skip_list<fragile_move, std::less<fragile_move>, DEFAULT_PROBABILITY, 8u,
+              test_helpers::counting_allocator<fragile_move>,
+              geometric_level_generator<DEFAULT_PROBABILITY, 8u>, NodePool>;
+
+// `sl` is sorted, walks `size()` elements and finds each of them.
+template <typename SkipList> void check_sorted_values(const SkipList &sl) {
+  ASSERT_TRUE(std::is_sorted(sl.begin(), sl.end()));
+  ASSERT_EQ(static_cast<std::size_t>(std::distance(sl.begin(), sl.end())),
+            sl.size());
+  for (const auto &el : sl) {
+    ASSERT_EQ(sl.find(el)->m_value, el.m_value);
+  }
+}
+} // namespace
+
+TEST(Operations, MergeSplicesNodes) {
+  check_merge(random_values(1000u, 500, 1u), random_values(1000u, 500, 2u));
+  check_merge(random_values(10u, 100, 3u), random_values(1000u, 100, 4u));
+  check_merge({}, random_values(100u, 100, 5u));
+  check_merge({1, 2, 3}, {4, 5, 6});
+  check_merge({4, 5, 6}, {1, 2, 3});
+  check_merge({1, 1, 1}, {1, 1});
+}
+
+TEST(Operations, MergeIntoEmpty) {
+  const auto values = random_values(200u, 100, 11u);
+  auto check = [&values](auto sl) {
+    decltype(sl) other(values.begin(), values.end());
+    const auto *first = &*other.begin();
+    sl.merge(other);
+    ASSERT_TRUE(other.empty());
+    ASSERT_EQ(other.begin(), other.end());
+    // The nodes of `other` change owner as they are.
+    ASSERT_EQ(&*sl.begin(), first);
+    ASSERT_EQ(sl.size(), values.size());
+    ASSERT_TRUE(std::is_sorted(sl.begin(), sl.end()));
+    for (auto value : values) {
+      ASSERT_NE(sl.find(value), sl.end());
+    }
+    other.push(50);
+    sl.merge(other);
+    ASSERT_EQ(sl.size(), values.size() + 1u);
+    ASSERT_TRUE(std::is_sorted(sl.begin(), sl.end()));
+  };
+  test_helpers::for_each_layout([&check]<bool Indexed, bool Bidirectional>() {
+    check(test_helpers::layout_list<int, Indexed, Bidirectional>{});
+  });
+  using pooled = test_helpers::layout_list<
+      int, false, false, std::less<int>, std::allocator<int>,
+      DEFAULT_MAX_NODE_SIZE, slab_node_pool<16u>>;
+  check(pooled{});
+
+  std::size_t calls = 0u;
+  using counted = skip_list<int, test_helpers::counting_less>;
+  counted sl(test_helpers::counting_less{&calls}, std::allocator<int>{});
+  counted other(test_helpers::counting_less{&calls}, std::allocator<int>{});
+  other.insert(values.begin(), values.end());
+  calls = 0u;
+  sl.merge(other);
+  // No element is visited.
+  ASSERT_EQ(calls, 0u);
+  ASSERT_EQ(sl.size(), values.size());
+}
+
+TEST(Operations, MergeSmallIntoLarge) {
+  check_merge(random_values(10000u, 3000, 6u), random_values(20u, 3000, 7u));
+  check_merge(random_values(1000u, 100, 8u), {-5, 0, 50, 50, 100, 1000});
+  check_merge(random_values(1000u, 100, 9u), {1000});
+  check_merge(random_values(1000u, 100, 10u), {-1});
+  std::vector<int> many_equal(1000u, 7);
+  check_merge(many_equal, {7, 7, 7});
+}
+
+TEST(Operations, SplitJoin) {
+  skip_list<int> sl{1, 2, 3, 3, 4, 5};
+  const auto *three = &*sl.lower_bound(3);
+  auto suffix = sl.split(3);
+  ASSERT_EQ(std::vector<int>(sl.begin(), sl.end()), (std::vector<int>{1, 2}));
+  ASSERT_EQ(std::vector<int>(suffix.begin(), suffix.end()),
+            (std::vector<int>{3, 3, 4, 5}));
+  // Nodes change list without being copied.
+  ASSERT_EQ(&*suffix.begin(), three);
+  ASSERT_TRUE(sl.split(10).empty());
+  auto all = sl.split(0);
+  ASSERT_TRUE(sl.empty());
+  ASSERT_EQ(all.size(), 2u);
+  all.join(suffix);
+  sl.join(std::move(all));
+  ASSERT_EQ(std::vector<int>(sl.begin(), sl.end()),
+            (std::vector<int>{1, 2, 3, 3, 4, 5}));
+  ASSERT_EQ(&*sl.lower_bound(3), three);
+  sl.join(sl);
+  ASSERT_EQ(sl.size(), 6u);
+}
+
+TEST(Operations, SplitJoinRandomized) {
+  using indexed = indexed_skip_list<int>;
+  using pooled =
+      skip_list<int, std::less<int>, DEFAULT_PROBABILITY, 8u,
+                std::allocator<int>,
+                geometric_level_generator<DEFAULT_PROBABILITY, 8u>,
+                slab_node_pool<16u>>;
+  for (unsigned seed = 0u; seed < 20u; ++seed) {
+    const auto keys = random_values(50u * seed, 1000, seed);
+    const auto key = static_cast<int>(seed * 53u % 1100u);
+    check_split_join<skip_list<int>>(keys, key);
+    check_split_join<indexed>(keys, key);
+    check_split_join<pooled>(keys, key);
+  }
+}
+
 TEST(Operations, StdSwap) {
   skip_list<int> sl{1, 3, 2};
   skip_list<int> sl_neg{-3, -1, -2, 0};
@@ -123,12 +370,6 @@ struct my_struct {
   explicit my_struct(int val) : ptr(new int{val}) {}
 };
 
-auto operator==(const my_struct &lhs, const my_struct &rhs) {
-  EXPECT_NE(lhs.ptr, nullptr);
-  EXPECT_NE(rhs.ptr, nullptr);
-  return *lhs.ptr == *rhs.ptr;
-}
-
 auto operator<=>(const my_struct &lhs, const my_struct &rhs) {
   EXPECT_NE(lhs.ptr, nullptr);
   EXPECT_NE(rhs.ptr, nullptr);
@@ -240,3 +481,102 @@ TEST(Operators, upperBound) {
     check_bound(11, 12);
   }
 }
+
+namespace {
+// Bounds, ranges and counts of every key against std::equal_range on the
+// sorted values.
+template <typename SkipList, typename Compare>
+void check_ranges(const std::vector<int> &values, Compare comp) {
+  const SkipList sl(values.begin(), values.end());
+  for (int key = -1; key <= 21; ++key) {
+    const auto [first, last] =
+        std::equal_range(values.begin(), values.end(), key, comp);
+    const auto range = sl.equal_range(key);
+    const auto before = std::distance(values.begin(), first);
+    const auto count = std::distance(first, last);
+    ASSERT_EQ(std::distance(sl.begin(), range.first), before);
+    ASSERT_EQ(std::distance(range.first, range.second), count);
+    ASSERT_EQ(sl.lower_bound(key), range.first);
+    ASSERT_EQ(sl.upper_bound(key), range.second);
+    ASSERT_EQ(sl.count(key), static_cast<std::size_t>(count));
+    ASSERT_EQ(sl.contains(key), count > 0);
+  }
+}
+} // namespace
+
+TEST(Operators, equalRange) {
+  const skip_list<int> empty;
+  EXPECT_EQ(empty.equal_range(0), std::make_pair(empty.end(), empty.end()));
+  EXPECT_EQ(empty.count(0), 0u);
+  EXPECT_FALSE(empty.contains(0));
+
+  std::vector<int> values{0, 2, 2, 2, 5, 7, 7, 20};
+  for (int i = 0; i < 50; ++i) {
+    values.push_back(10);
+  }
+  std::sort(values.begin(), values.end());
+  check_ranges<skip_list<int>>(values, std::less<>{});
+  check_ranges<indexed_skip_list<int>>(values, std::less<>{});
+  std::reverse(values.begin(), values.end());
+  check_ranges<skip_list<int, std::greater<>>>(values, std::greater<>{});
+  check_ranges<indexed_skip_list<int, std::greater<>>>(values,
+                                                       std::greater<>{});
+}
+
+TEST(Operations, SplitJoinKeepElementsOnThrow) {
+  // A pooled split moves the suffix into new nodes, a throwing move puts
+  // every element back.
+  test_helpers::allocation_stats stats;
+  {
+    fragile_move_list<slab_node_pool<8u>> sl{
+        test_helpers::counting_allocator<fragile_move>(&stats)};
+    for (int i = 0; i < 100; ++i) {
+      sl.emplace(i);
+    }
+    fragile_move::s_budget = 10;
+    ASSERT_THROW(sl.split(fragile_move(50)), std::runtime_error);
+    fragile_move::s_budget = -1;
+    ASSERT_EQ(sl.size(), 100u);
+    auto it = sl.begin();
+    for (int i = 0; i < 100; ++i, ++it) {
+      ASSERT_EQ(it->m_value, i);
+    }
+    check_sorted_values(sl);
+    sl.emplace(100);
+    ASSERT_EQ(sl.back().m_value, 100);
+  }
+  ASSERT_EQ(stats.allocations, stats.deallocations);
+  ASSERT_EQ(stats.live_bytes, 0u);
+
+  // A join between different allocators moves `other` into new nodes.
+  test_helpers::allocation_stats other_stats;
+  {
+    fragile_move_list<no_node_pool> sl{
+        test_helpers::counting_allocator<fragile_move>(&stats)};
+    fragile_move_list<no_node_pool> other{
+        test_helpers::counting_allocator<fragile_move>(&other_stats)};
+    for (int i = 0; i < 50; ++i) {
+      sl.emplace(i);
+      other.emplace(i + 50);
+    }
+    fragile_move::s_budget = 10;
+    ASSERT_THROW(sl.join(other), std::runtime_error);
+    fragile_move::s_budget = -1;
+    // The moved elements left `other`, each one is in exactly one list.
+    ASSERT_EQ(sl.size(), 60u);
+    ASSERT_EQ(other.size(), 40u);
+    check_sorted_values(sl);
+    check_sorted_values(other);
+    ASSERT_EQ(sl.back().m_value, 59);
+    ASSERT_EQ(other.front().m_value, 60);
+    for (const auto &el : other) {
+      ASSERT_EQ(sl.find(el), sl.end());
+    }
+    other.clear();
+    other.emplace(1);
+    ASSERT_EQ(other.front().m_value, 1);
+  }
+  ASSERT_EQ(stats.allocations, stats.deallocations);
+  ASSERT_EQ(other_stats.allocations, other_stats.deallocations);
+  ASSERT_EQ(other_stats.live_bytes, 0u);
+}
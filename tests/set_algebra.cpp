@@ -0,0 +1,124 @@
+#include <gtest/gtest.h>
+
+#include "skip_list.hpp"
+#include "test_helpers.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+using namespace sl;
+using test_helpers::counting_less;
+using test_helpers::random_values;
+
+namespace {
+template <typename SkipList>
+void check_list(const SkipList &sl, const std::vector<int> &expected) {
+  ASSERT_EQ(sl.size(), expected.size());
+  ASSERT_TRUE(
+      std::equal(sl.begin(), sl.end(), expected.begin(), expected.end()));
+  for (auto value : expected) {
+    ASSERT_NE(sl.find(value), sl.end());
+  }
+}
+
+// Every operation against its std algorithm on the sorted values.
+template <typename SkipList>
+void check_operations(const std::vector<int> &lhs_values,
+                      const std::vector<int> &rhs_values) {
+  const SkipList lhs(lhs_values.begin(), lhs_values.end());
+  const SkipList rhs(rhs_values.begin(), rhs_values.end());
+  std::vector<int> expected;
+  std::set_union(lhs_values.begin(), lhs_values.end(), rhs_values.begin(),
+                 rhs_values.end(), std::back_inserter(expected));
+  check_list(set_union(lhs, rhs), expected);
+  expected.clear();
+  std::set_intersection(lhs_values.begin(), lhs_values.end(),
+                        rhs_values.begin(), rhs_values.end(),
+                        std::back_inserter(expected));
+  check_list(set_intersection(lhs, rhs), expected);
+  expected.clear();
+  std::set_difference(lhs_values.begin(), lhs_values.end(), rhs_values.begin(),
+                      rhs_values.end(), std::back_inserter(expected));
+  check_list(set_difference(lhs, rhs), expected);
+  expected.clear();
+  std::set_symmetric_difference(lhs_values.begin(), lhs_values.end(),
+                                rhs_values.begin(), rhs_values.end(),
+                                std::back_inserter(expected));
+  check_list(set_symmetric_difference(lhs, rhs), expected);
+}
+} // namespace
+
+TEST(SetAlgebra, Basic) {
+  const skip_list<int> lhs{1, 2, 2, 3, 5, 8};
+  const skip_list<int> rhs{2, 3, 3, 4, 8, 9};
+  check_list(set_union(lhs, rhs), {1, 2, 2, 3, 3, 4, 5, 8, 9});
+  check_list(set_intersection(lhs, rhs), {2, 3, 8});
+  check_list(set_difference(lhs, rhs), {1, 2, 5});
+  check_list(set_difference(rhs, lhs), {3, 4, 9});
+  check_list(set_symmetric_difference(lhs, rhs), {1, 2, 3, 4, 5, 9});
+  const skip_list<int> empty;
+  check_list(set_union(lhs, empty), {1, 2, 2, 3, 5, 8});
+  check_list(set_intersection(empty, rhs), {});
+  check_list(set_difference(empty, rhs), {});
+  check_list(set_symmetric_difference(empty, rhs), {2, 3, 3, 4, 8, 9});
+}
+
+TEST(SetAlgebra, QualifiedCalls) {
+  const indexed_skip_list<int> lhs{1, 2, 3, 5, 8};
+  const indexed_skip_list<int> rhs{2, 3, 4, 8};
+  check_list(sl::set_union(lhs, rhs), {1, 2, 3, 4, 5, 8});
+  check_list(sl::set_intersection(lhs, rhs), {2, 3, 8});
+  check_list(sl::set_difference(lhs, rhs), {1, 5});
+  check_list(sl::set_symmetric_difference(lhs, rhs), {1, 4, 5});
+}
+
+TEST(SetAlgebra, KeepsElementsOfLhs) {
+  auto comp = [](const std::pair<int, int> &lhs,
+                 const std::pair<int, int> &rhs) {
+    return lhs.first < rhs.first;
+  };
+  using list = skip_list<std::pair<int, int>, decltype(comp)>;
+  const list lhs{{1, 0}, {2, 0}};
+  const list rhs{{2, 1}, {3, 1}};
+  const auto both = set_intersection(lhs, rhs);
+  ASSERT_EQ(both.size(), 1u);
+  ASSERT_EQ(both.front(), std::make_pair(2, 0));
+  const auto all = set_union(lhs, rhs);
+  ASSERT_EQ((std::vector<std::pair<int, int>>(all.begin(), all.end())),
+            (std::vector<std::pair<int, int>>{{1, 0}, {2, 0}, {3, 1}}));
+}
+
+TEST(SetAlgebra, Randomized) {
+  for (unsigned seed = 0u; seed < 10u; ++seed) {
+    auto lhs = random_values(40u * seed, 500, seed);
+    auto rhs = random_values(400u - 30u * seed, 500, seed + 100u);
+    std::sort(lhs.begin(), lhs.end());
+    std::sort(rhs.begin(), rhs.end());
+    check_operations<skip_list<int>>(lhs, rhs);
+    check_operations<indexed_skip_list<int>>(lhs, rhs);
+  }
+}
+
+TEST(SetAlgebra, IntersectionGallops) {
+  constexpr int LARGE = 100000;
+  std::size_t calls = 0u;
+  using list = skip_list<int, counting_less, DEFAULT_PROBABILITY, 32u>;
+  list large(counting_less{&calls}, std::allocator<int>{});
+  list small(counting_less{&calls}, std::allocator<int>{});
+  for (int i = 0; i < LARGE; ++i) {
+    large.insert(large.end(), i);
+  }
+  for (int i = 0; i < LARGE; i += LARGE / 100) {
+    small.insert(small.end(), i);
+  }
+  calls = 0u;
+  const auto both = set_intersection(small, large);
+  ASSERT_EQ(both.size(), small.size());
+  // A walk of the large list alone would cost a comparison per element.
+  ASSERT_LT(calls, 100u * 60u);
+  calls = 0u;
+  ASSERT_TRUE(set_difference(small, large).empty());
+  ASSERT_LT(calls, 100u * 60u);
+}
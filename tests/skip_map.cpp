@@ -0,0 +1,142 @@
+#include <gtest/gtest.h>
+
+#include "skip_list.hpp"
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+using namespace sl;
+
+namespace {
+// Counts every payload built, so a rejected insertion that builds one is
+// caught.
+struct payload {
+  explicit payload(int value = 0) : m_value(value) { ++s_built; }
+  payload(const payload &other) : m_value(other.m_value) { ++s_built; }
+  payload(payload &&other) noexcept : m_value(other.m_value) { ++s_built; }
+  payload &operator=(const payload &) = default;
+  payload &operator=(payload &&) noexcept = default;
+  ~payload() = default;
+
+  int m_value;
+  static std::size_t s_built;
+};
+std::size_t payload::s_built = 0u;
+
+template <typename Map> std::vector<int> keys(const Map &map) {
+  std::vector<int> result;
+  for (const auto &[key, value] : map) {
+    result.push_back(key);
+  }
+  return result;
+}
+} // namespace
+
+TEST(SkipMap, InsertAndFind) {
+  skip_map<int, std::string> map{{3, "c"}, {1, "a"}, {2, "b"}, {1, "z"}};
+  ASSERT_EQ(map.size(), 3u);
+  ASSERT_EQ(keys(map), (std::vector<int>{1, 2, 3}));
+  // Of equivalent keys the first one is kept.
+  ASSERT_EQ(map.find(1)->second, "a");
+  ASSERT_EQ(map.find(4), map.end());
+  ASSERT_TRUE(map.contains(2));
+  ASSERT_EQ(map.count(5), 0u);
+  const auto [it, inserted] = map.insert({2, "y"});
+  ASSERT_FALSE(inserted);
+  ASSERT_EQ(it->second, "b");
+  ASSERT_TRUE(map.insert({0, "o"}).second);
+  ASSERT_EQ(map.begin()->first, 0);
+  ASSERT_EQ(map.lower_bound(2)->first, 2);
+  ASSERT_EQ(map.upper_bound(2)->first, 3);
+  ASSERT_EQ(map.erase(2), 1u);
+  ASSERT_EQ(map.erase(2), 0u);
+  ASSERT_EQ(map.erase(map.find(0))->first, 1);
+  ASSERT_EQ(keys(map), (std::vector<int>{1, 3}));
+  map.clear();
+  ASSERT_TRUE(map.empty());
+}
+
+TEST(SkipMap, TryEmplaceLeavesArgumentsAlone) {
+  skip_map<std::string, payload> map;
+  ASSERT_TRUE(map.try_emplace("one", 1).second);
+  payload::s_built = 0u;
+  auto [it, inserted] = map.try_emplace("one", 2);
+  ASSERT_FALSE(inserted);
+  ASSERT_EQ(it->second.m_value, 1);
+  // The value is only built once the key is known to be absent.
+  ASSERT_EQ(payload::s_built, 0u);
+  std::string key{"two"};
+  ASSERT_TRUE(map.try_emplace(std::move(key), 2).second);
+  ASSERT_EQ(payload::s_built, 1u);
+  std::string existing{"two"};
+  ASSERT_FALSE(map.try_emplace(std::move(existing), 3).second);
+  // A rejected key is not moved from.
+  ASSERT_EQ(existing, "two");
+  ASSERT_EQ(map.at("two").m_value, 2);
+}
+
+TEST(SkipMap, AssignThroughIterators) {
+  skip_map<int, int> map;
+  for (int i = 0; i < 100; ++i) {
+    map[i % 10] += i;
+  }
+  ASSERT_EQ(map.size(), 10u);
+  ASSERT_EQ(map[3], 3 + 13 + 23 + 33 + 43 + 53 + 63 + 73 + 83 + 93);
+  for (auto &[key, value] : map) {
+    value = key * key;
+  }
+  for (auto it = map.begin(); it != map.end(); ++it) {
+    ASSERT_EQ(it->second, it->first * it->first);
+  }
+  ASSERT_FALSE(map.insert_or_assign(4, -1).second);
+  ASSERT_TRUE(map.insert_or_assign(40, -2).second);
+  ASSERT_EQ(map.at(4), -1);
+  ASSERT_EQ(map.at(40), -2);
+  ASSERT_THROW((void)map.at(41), std::out_of_range);
+  const auto &cmap = map;
+  ASSERT_EQ(cmap.at(9), 81);
+  ASSERT_THROW((void)cmap.at(-1), std::out_of_range);
+}
+
+TEST(SkipMap, InsertOrAssignForwardsOnce) {
+  skip_map<int, std::unique_ptr<int>> map;
+  auto first = std::make_unique<int>(1);
+  ASSERT_TRUE(map.insert_or_assign(1, std::move(first)).second);
+  ASSERT_EQ(*map.at(1), 1);
+  auto second = std::make_unique<int>(2);
+  const auto [it, inserted] = map.insert_or_assign(1, std::move(second));
+  ASSERT_FALSE(inserted);
+  ASSERT_EQ(*it->second, 2);
+  ASSERT_EQ(map.size(), 1u);
+  skip_map<std::string, payload> payloads;
+  payload value{3};
+  payload::s_built = 0u;
+  ASSERT_TRUE(payloads.insert_or_assign("key", value).second);
+  ASSERT_FALSE(payloads.insert_or_assign("key", payload{4}).second);
+  // The copy in the new entry and the temporary, which is then assigned.
+  ASSERT_EQ(payload::s_built, 2u);
+  ASSERT_EQ(payloads.at("key").m_value, 4);
+}
+
+TEST(SkipMap, TransparentLookup) {
+  skip_map<std::string, int, std::less<>> map{
+      {"apple", 1}, {"banana", 2}, {"cherry", 3}};
+  ASSERT_EQ(map.find(std::string_view{"banana"})->second, 2);
+  ASSERT_EQ(map.find(std::string_view{"date"}), map.end());
+  ASSERT_TRUE(map.contains(std::string_view{"cherry"}));
+  ASSERT_EQ(map.erase(std::string_view{"apple"}), 1u);
+  ASSERT_EQ(map.begin()->first, "banana");
+}
+
+TEST(SkipMap, Ordering) {
+  skip_map<int, int, std::greater<>> map{{1, 1}, {5, 5}, {3, 3}};
+  ASSERT_EQ(keys(map), (std::vector<int>{5, 3, 1}));
+  skip_map<int, int, std::greater<>> other{{5, 5}, {1, 1}, {3, 3}};
+  ASSERT_EQ(map, other);
+  other[3] = 4;
+  ASSERT_NE(map, other);
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "skip_list.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <random>
+#include <type_traits>
+#include <vector>
+
+// Helpers shared by the test files.
+namespace test_helpers {
+
+struct allocation_stats {
+  std::size_t allocations{0u};
+  std::size_t deallocations{0u};
+  std::size_t live_bytes{0u};
+};
+
+// Forwards to std::allocator and records every call in `allocation_stats`.
+// Copies compare equal only when they share their stats, so lists with
+// different stats cannot exchange nodes.
+template <typename T> struct counting_allocator {
+  using value_type = T;
+  using is_always_equal = std::false_type;
+
+  explicit counting_allocator(allocation_stats *stats) : m_stats(stats) {}
+  template <typename U>
+  explicit counting_allocator(const counting_allocator<U> &other) noexcept
+      : m_stats(other.m_stats) {}
+
+  T *allocate(std::size_t n) {
+    ++m_stats->allocations;
+    m_stats->live_bytes += n * sizeof(T);
+    return std::allocator<T>{}.allocate(n);
+  }
+
+  void deallocate(T *ptr, std::size_t n) noexcept {
+    ++m_stats->deallocations;
+    m_stats->live_bytes -= n * sizeof(T);
+    std::allocator<T>{}.deallocate(ptr, n);
+  }
+
+  template <typename U>
+  bool operator==(const counting_allocator<U> &rhs) const noexcept {
+    return m_stats == rhs.m_stats;
+  }
+
+  allocation_stats *m_stats;
+};
+
+// Counts every comparison into `*m_calls`.
+struct counting_less {
+  bool operator()(int lhs, int rhs) const {
+    ++*m_calls;
+    return lhs < rhs;
+  }
+  std::size_t *m_calls;
+};
+
+inline std::vector<int>
+random_values(std::size_t count, int max, unsigned seed) {
+  std::mt19937 gen(seed);
+  std::uniform_int_distribution<int> value(0, max);
+  std::vector<int> values(count);
+  std::generate(values.begin(), values.end(), [&] { return value(gen); });
+  return values;
+}
+
+// A `skip_list` with its two node layout flags up front.
+template <typename T, bool Indexed, bool Bidirectional,
+          typename Compare = std::less<T>,
+          typename Allocator = std::allocator<T>,
+          std::size_t MaxNodeSize = sl::DEFAULT_MAX_NODE_SIZE,
+          typename NodePool = sl::no_node_pool>
+using layout_list =
+    sl::skip_list<T, Compare, sl::DEFAULT_PROBABILITY, MaxNodeSize, Allocator,
+                  sl::geometric_level_generator<sl::DEFAULT_PROBABILITY,
+                                                MaxNodeSize>,
+                  NodePool, Indexed, Bidirectional>;
+
+// Runs `check.template operator()<Indexed, Bidirectional>()` for all four
+// node layouts.
+template <typename Check> void for_each_layout(const Check &check) {
+  check.template operator()<false, false>();
+  check.template operator()<true, false>();
+  check.template operator()<false, true>();
+  check.template operator()<true, true>();
+}
+
+} // namespace test_helpers
@@ -0,0 +1,116 @@
+#include <gtest/gtest.h>
+
+#include "skip_list.hpp"
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace sl;
+
+namespace {
+// Counts every record built, so a lookup that builds a temporary is caught.
+struct record {
+  explicit record(int id) : m_id(id) { ++s_built; }
+  record(const record &other) : m_id(other.m_id) { ++s_built; }
+  record(record &&other) noexcept : m_id(other.m_id) { ++s_built; }
+  record &operator=(const record &) = default;
+  record &operator=(record &&) noexcept = default;
+  ~record() = default;
+
+  int m_id;
+  static std::size_t s_built;
+};
+std::size_t record::s_built = 0u;
+
+// Compares records with bare ids, records have no `operator==` so lookups
+// match by equivalence.
+struct by_id {
+  using is_transparent = void;
+  bool operator()(const record &lhs, const record &rhs) const {
+    return lhs.m_id < rhs.m_id;
+  }
+  bool operator()(const record &lhs, int rhs) const { return lhs.m_id < rhs; }
+  bool operator()(int lhs, const record &rhs) const { return lhs < rhs.m_id; }
+};
+
+template <typename SkipList> SkipList records(int count) {
+  SkipList sl;
+  for (int id = 0; id < count; ++id) {
+    sl.insert(sl.end(), record(2 * id));
+  }
+  return sl;
+}
+
+template <typename SkipList> void check_records() {
+  auto sl = records<SkipList>(100);
+  record::s_built = 0u;
+  for (int id = -1; id < 200; ++id) {
+    const auto it = sl.find(id);
+    if (id >= 0 && id % 2 == 0) {
+      ASSERT_NE(it, sl.end());
+      ASSERT_EQ(it->m_id, id);
+    } else {
+      ASSERT_EQ(it, sl.end());
+    }
+    const auto lower = sl.lower_bound(id);
+    const auto upper = sl.upper_bound(id);
+    if (id >= 198) {
+      ASSERT_EQ(upper, sl.end());
+    } else {
+      ASSERT_EQ(upper->m_id, id < 0 ? 0 : id + (id % 2 == 0 ? 2 : 1));
+    }
+    if (id > 198) {
+      ASSERT_EQ(lower, sl.end());
+    } else {
+      ASSERT_EQ(lower->m_id, id < 0 ? 0 : id + id % 2);
+    }
+  }
+  ASSERT_EQ(record::s_built, 0u);
+  ASSERT_EQ(sl.erase(7), sl.end());
+  ASSERT_EQ(sl.erase(8)->m_id, 10);
+  ASSERT_FALSE(sl.extract(9).has_value());
+  record::s_built = 0u;
+  ASSERT_EQ(sl.extract(10)->m_id, 10);
+  // Only the returned optional is built.
+  ASSERT_EQ(record::s_built, 1u);
+  ASSERT_EQ(sl.size(), 98u);
+  ASSERT_EQ(sl.find(8), sl.end());
+  ASSERT_EQ(sl.find(10), sl.end());
+  ASSERT_EQ(sl.find(12)->m_id, 12);
+}
+} // namespace
+
+TEST(TransparentLookup, StringView) {
+  skip_list<std::string, std::less<>> sl{"banana", "apple", "cherry", "date"};
+  constexpr std::string_view apple{"apple"};
+  ASSERT_EQ(*sl.find(apple), "apple");
+  ASSERT_EQ(sl.find(std::string_view{"blueberry"}), sl.end());
+  ASSERT_EQ(*sl.lower_bound(std::string_view{"blueberry"}), "cherry");
+  ASSERT_EQ(*sl.upper_bound(std::string_view{"banana"}), "cherry");
+  ASSERT_EQ(*sl.erase(std::string_view{"banana"}), "cherry");
+  ASSERT_EQ(sl.extract(std::string_view{"date"}), "date");
+  ASSERT_FALSE(sl.extract(std::string_view{"date"}).has_value());
+  ASSERT_EQ((std::vector<std::string>(sl.begin(), sl.end())),
+            (std::vector<std::string>{"apple", "cherry"}));
+  // Keys of `T` itself still take the non-template overloads.
+  ASSERT_EQ(*sl.find(std::string{"cherry"}), "cherry");
+  ASSERT_EQ(*sl.find("apple"), "apple");
+}
+
+TEST(TransparentLookup, NoTemporaryKeys) {
+  check_records<skip_list<record, by_id>>();
+  check_records<indexed_skip_list<record, by_id>>();
+}
+
+TEST(TransparentLookup, BoundsUseComparator) {
+  skip_list<int, std::greater<>> sl{1, 5, 3, 5, 9};
+  ASSERT_EQ((std::vector<int>(sl.begin(), sl.end())),
+            (std::vector<int>{9, 5, 5, 3, 1}));
+  ASSERT_EQ(*sl.lower_bound(5), 5);
+  ASSERT_EQ(std::distance(sl.begin(), sl.lower_bound(5)), 1);
+  ASSERT_EQ(*sl.upper_bound(5), 3);
+  ASSERT_EQ(*sl.lower_bound(4), 3);
+  ASSERT_EQ(sl.lower_bound(0), sl.end());
+  ASSERT_EQ(sl.upper_bound(10), sl.begin());
+}